@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Measures dispatch latency (time between Execute call and task start) and throughput of the pool
+ * under bursty load: producers submit bursts of tasks and then stay silent long enough for the pool
+ * to shrink back to low watermark.
+ *
+ * Usage: runExecutorBench [bursts] [burst_size] [producers]
+ */
+int main(int argc, char **argv) {
+    const int bursts = argc > 1 ? std::atoi(argv[1]) : 20;
+    const int burst_size = argc > 2 ? std::atoi(argv[2]) : 10000;
+    const int producers = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    Executor executor("bench", burst_size * producers, 2, std::thread::hardware_concurrency() * 2, 5);
+    executor.Start();
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(bursts * burst_size * producers);
+    std::mutex latencies_mutex;
+
+    std::atomic<int> done(0), rejected(0);
+    auto task = [&](Clock::time_point submitted) {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - submitted).count();
+        {
+            std::lock_guard<std::mutex> lock(latencies_mutex);
+            latencies.push_back(ns);
+        }
+        done++;
+    };
+
+    auto started = Clock::now();
+    Clock::duration busy(0);
+    for (int b = 0; b < bursts; b++) {
+        auto burst_start = Clock::now();
+        int target = done.load() + rejected.load() + burst_size * producers;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < burst_size; i++) {
+                    if (!executor.Execute(task, Clock::now())) {
+                        rejected++;
+                    }
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        while (done.load() + rejected.load() < target) {
+            std::this_thread::yield();
+        }
+        busy += Clock::now() - burst_start;
+
+        // Silence between bursts, let the pool shrink
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    auto total = Clock::now() - started;
+    executor.Stop(true);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) { return latencies.empty() ? 0 : latencies[std::size_t(p * (latencies.size() - 1))]; };
+
+    double busy_sec = std::chrono::duration<double>(busy).count();
+    std::cout << "tasks: " << done.load() << " rejected: " << rejected.load()
+              << " wall: " << std::chrono::duration<double>(total).count() << "s" << std::endl;
+    std::cout << "throughput: " << static_cast<int64_t>(done.load() / busy_sec) << " tasks/s (during bursts)"
+              << std::endl;
+    std::cout << "dispatch latency ns: p50=" << pct(0.5) << " p90=" << pct(0.9) << " p99=" << pct(0.99)
+              << " max=" << pct(1.0) << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/Task.h>
+
+using namespace Afina::Concurrency;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Compares cost of wrapping a connection-sized closure into std::function vs Task and counts
+ * heap allocations per submission into the Executor.
+ *
+ * Usage: runTaskBench [iterations]
+ */
+
+static std::atomic<uint64_t> allocations(0);
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+// Looks like what network layer would submit: connection, storage and socket
+struct Closure {
+    void *connection;
+    std::shared_ptr<int> storage;
+    int socket;
+    uint64_t *sink;
+
+    void operator()() { *sink += socket; }
+};
+
+template <typename Wrapper> static void wrap(const std::string &name, int iterations, std::shared_ptr<int> storage) {
+    uint64_t sink = 0;
+    uint64_t before = allocations.load();
+    auto started = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        Wrapper w(Closure{nullptr, storage, i, &sink});
+        w();
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / iterations;
+    double allocs = double(allocations.load() - before) / iterations;
+    std::cout << name << ": " << ns << " ns/op, " << allocs << " allocations/op (sink " << sink << ")" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::shared_ptr<int> storage = std::make_shared<int>(0);
+
+    std::cout << "closure size: " << sizeof(Closure) << " bytes, Task inline size: " << Task::kInlineSize << std::endl;
+    wrap<std::function<void()>>("std::function", iterations, storage);
+    wrap<Task>("Task", iterations, storage);
+
+    // Steady state submissions into pool: node pool is warm after the first round
+    Executor executor("bench", iterations, 1, 1, 1000);
+    executor.Start();
+
+    std::atomic<uint64_t> done(0);
+    auto submit = [&](int n) {
+        for (int i = 0; i < n; i++) {
+            executor.Execute([&done, storage, i]() { done += i & 1; });
+        }
+    };
+
+    submit(10000);
+    executor.Stop(true);
+    executor.Start();
+
+    uint64_t before = allocations.load();
+    auto started = Clock::now();
+    submit(iterations);
+    executor.Stop(true);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - started).count() / iterations;
+    double allocs = double(allocations.load() - before) / iterations;
+    std::cout << "Executor::Execute: " << ns << " ns/op end-to-end, " << allocs << " allocations/op" << std::endl;
+    return 0;
+}
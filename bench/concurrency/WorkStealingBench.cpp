@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/WorkStealingExecutor.h>
+
+using namespace Afina::Concurrency;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Compares mutex-queue Executor against WorkStealingExecutor with the same number of threads:
+ * - external: several producer threads submit tiny tasks from outside of the pool
+ * - fanout: tasks submit children from inside of the pool (recursive decomposition)
+ *
+ * Usage: runWorkStealingBench [threads] [tasks]
+ */
+
+template <typename Pool> static void _fanout(Pool &pool, std::atomic<int> &counter, int depth) {
+    counter++;
+    if (depth > 0) {
+        pool.Execute(_fanout<Pool>, std::ref(pool), std::ref(counter), depth - 1);
+        pool.Execute(_fanout<Pool>, std::ref(pool), std::ref(counter), depth - 1);
+    }
+}
+
+template <typename Pool> static double external(Pool &pool, int producers, int tasks) {
+    std::atomic<int> counter(0);
+    auto started = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&pool, &counter, tasks, producers]() {
+            for (int i = 0; i < tasks / producers; i++) {
+                while (!pool.Execute([&counter]() { counter++; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    while (counter.load() < (tasks / producers) * producers) {
+        std::this_thread::yield();
+    }
+    return std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+template <typename Pool> static double fanout(Pool &pool, int depth) {
+    std::atomic<int> counter(0);
+    auto started = Clock::now();
+    pool.Execute(_fanout<Pool>, std::ref(pool), std::ref(counter), depth);
+    while (counter.load() < (1 << (depth + 1)) - 1) {
+        std::this_thread::yield();
+    }
+    return std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+static void report(const std::string &name, const std::string &scenario, int tasks, double sec) {
+    std::cout << name << " " << scenario << ": " << tasks << " tasks in " << sec << "s, "
+              << static_cast<int64_t>(tasks / sec) << " tasks/s" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    const int threads = argc > 1 ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+    const int tasks = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    int depth = 0;
+    while ((2 << (depth + 1)) - 1 <= tasks) {
+        depth++;
+    }
+    const int fanout_tasks = (1 << (depth + 1)) - 1;
+
+    {
+        Executor pool("mutex", tasks, threads, threads, 1000);
+        pool.Start();
+        report("mutex-queue", "external", tasks, external(pool, 4, tasks));
+        report("mutex-queue", "fanout", fanout_tasks, fanout(pool, depth));
+        pool.Stop(true);
+    }
+
+    {
+        WorkStealingExecutor pool("stealing", threads);
+        pool.Start();
+        report("work-stealing", "external", tasks, external(pool, 4, tasks));
+        report("work-stealing", "fanout", fanout_tasks, fanout(pool, depth));
+        pool.Stop(true);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Measures throughput of the running server with pipelined requests: every connection sends depth
+ * gets in one write and waits for all responses before sending the next round.
+ *
+ * Usage: runPipelineBench [port] [connections] [depth] [rounds] [keys]
+ */
+
+static int connect_to(int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        throw std::runtime_error("Failed to open socket");
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        close(sock);
+        throw std::runtime_error("Failed to connect to server");
+    }
+
+    int on = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return sock;
+}
+
+static void send_all(int sock, const std::string &data) {
+    for (std::size_t sent = 0; sent < data.size();) {
+        ssize_t n = write(sock, data.data() + sent, data.size() - sent);
+        if (n <= 0) {
+            throw std::runtime_error("Failed to send request");
+        }
+        sent += n;
+    }
+}
+
+// Reads until the given number of responses ended by "END\r\n" or "STORED\r\n" arrive
+static void receive(int sock, std::size_t responses, std::string &buffer) {
+    static const std::string end = "END\r\n", stored = "STORED\r\n";
+    std::size_t done = 0, scanned = 0;
+    buffer.clear();
+    char chunk[64 * 1024];
+    while (done < responses) {
+        ssize_t n = read(sock, chunk, sizeof(chunk));
+        if (n <= 0) {
+            throw std::runtime_error("Failed to read response");
+        }
+        buffer.append(chunk, n);
+
+        // Responses end with either marker, values of the bench never contain them
+        for (std::size_t pos; (pos = buffer.find("\r\n", scanned)) != std::string::npos; scanned = pos + 2) {
+            if ((pos + 2 >= end.size() && buffer.compare(pos + 2 - end.size(), end.size(), end) == 0) ||
+                (pos + 2 >= stored.size() && buffer.compare(pos + 2 - stored.size(), stored.size(), stored) == 0)) {
+                done++;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    const int connections = argc > 2 ? std::atoi(argv[2]) : 4;
+    const int depth = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int rounds = argc > 4 ? std::atoi(argv[4]) : 2000;
+    const int keys = argc > 5 ? std::atoi(argv[5]) : 1000;
+
+    // Fill the storage
+    {
+        int sock = connect_to(port);
+        std::string request, buffer;
+        for (int i = 0; i < keys; i++) {
+            std::string value = "value" + std::to_string(i);
+            request += "set key" + std::to_string(i) + " 0 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+        }
+        send_all(sock, request);
+        receive(sock, keys, buffer);
+        close(sock);
+    }
+
+    std::atomic<bool> go(false);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < connections; c++) {
+        clients.emplace_back([&, c]() {
+            int sock = connect_to(port);
+
+            // Every round asks for the next depth keys
+            std::vector<std::string> requests;
+            for (int i = 0; i < keys; i += depth) {
+                std::string request;
+                for (int j = 0; j < depth; j++) {
+                    request += "get key" + std::to_string((c * 7 + i + j) % keys) + "\r\n";
+                }
+                requests.push_back(request);
+            }
+
+            std::string buffer;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int r = 0; r < rounds; r++) {
+                send_all(sock, requests[r % requests.size()]);
+                receive(sock, depth, buffer);
+            }
+            close(sock);
+        });
+    }
+
+    auto started = Clock::now();
+    go.store(true);
+    for (auto &c : clients) {
+        c.join();
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - started).count();
+
+    const int64_t total = int64_t(connections) * rounds * depth;
+    std::cout << "pipelined gets (depth " << depth << "): " << total << " in " << sec << "s, "
+              << static_cast<int64_t>(total / sec) << " gets/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/PoolResource.h>
+#include <afina/allocator/SlabCache.h>
+#include <afina/concurrency/Numa.h>
+
+#include "storage/ShardedStorage.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Compares NUMA placement of requests: threads bound to nodes either serve random keys ("unrouted",
+ * what happens when any worker takes any request) or only keys whose shard lives on their node
+ * ("routed", what mt_nonblock does in NUMA mode). Reports throughput and share of requests that
+ * touched memory of another node.
+ *
+ * On a single node box fake topology is used: remote share still shows what routing saves, while
+ * throughput difference shows up on real multi socket machines only.
+ *
+ * Usage: runNumaBench [nodes (0 to detect)] [threads_per_node] [ops_per_thread] [keys]
+ */
+
+struct Result {
+    double seconds;
+    int64_t remote;
+};
+
+static Result run(Storage &storage, const Concurrency::Topology &numa, int per_node, int ops,
+                  const std::vector<std::vector<std::string>> &keys, bool routed) {
+    std::vector<std::string> all;
+    for (auto &node_keys : keys) {
+        all.insert(all.end(), node_keys.begin(), node_keys.end());
+    }
+
+    std::atomic<bool> go(false);
+    std::atomic<int64_t> remote(0);
+    std::vector<std::thread> workers;
+    for (std::size_t node = 0; node < numa.Nodes(); node++) {
+        for (int t = 0; t < per_node; t++) {
+            workers.emplace_back([&, node, t]() {
+                numa.Bind(node);
+                const std::vector<std::string> &mine = routed ? keys[node] : all;
+                std::minstd_rand rnd(node * per_node + t + 1);
+                std::string value;
+                int64_t misses = 0;
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                for (int i = 0; i < ops; i++) {
+                    const std::string &key = mine[rnd() % mine.size()];
+                    if (storage.NodeOf(key) != int(node)) {
+                        misses++;
+                    }
+                    if (rnd() % 10 != 0) {
+                        storage.Get(key, value);
+                    } else {
+                        storage.Put(key, key);
+                    }
+                }
+                remote.fetch_add(misses);
+            });
+        }
+    }
+
+    auto started = Clock::now();
+    go.store(true);
+    for (auto &w : workers) {
+        w.join();
+    }
+    return {std::chrono::duration<double>(Clock::now() - started).count(), remote.load()};
+}
+
+static void report(const std::string &name, int64_t total, const Result &r) {
+    std::cout << name << ": " << total << " ops in " << r.seconds << "s, " << static_cast<int64_t>(total / r.seconds)
+              << " ops/s, remote " << r.remote << " (" << 100.0 * r.remote / total << "%)" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    const int nodes = argc > 1 ? std::atoi(argv[1]) : 2;
+    const int per_node = argc > 2 ? std::atoi(argv[2]) : 2;
+    const int ops = argc > 3 ? std::atoi(argv[3]) : 200000;
+    const int nkeys = argc > 4 ? std::atoi(argv[4]) : 100000;
+    const std::size_t memory = 256 * 1024 * 1024;
+
+    Concurrency::Topology numa = nodes > 0 ? Concurrency::Topology::Fake(nodes) : Concurrency::Topology::Detect();
+    std::cout << numa.Describe() << std::endl;
+
+    // Four shards per node, each taking memory from pools of its node
+    const std::size_t shards = 4 * numa.Nodes();
+    std::vector<std::shared_ptr<Storage>> parts;
+    std::vector<int> owners;
+    std::vector<Allocator::PoolResource *> pools;
+    for (std::size_t node = 0; node < numa.Nodes(); node++) {
+        Allocator::Arena *arena = new Allocator::Arena(64 * Allocator::Arena::kSlabSize);
+        arena->SetPolicy(Allocator::PagePolicy(Allocator::PageKind::Normal, false, numa.At(node).memory));
+        pools.push_back(new Allocator::PoolResource(Allocator::NewDeleteResource(), *new Allocator::SlabCache(*arena)));
+    }
+    for (std::size_t i = 0; i < shards; i++) {
+        parts.push_back(
+            std::make_shared<Backend::ThreadSafeSimplLRU>(memory / shards, nkeys / shards, pools[i % numa.Nodes()]));
+        owners.push_back(i % numa.Nodes());
+    }
+    Backend::ShardedStorage storage(parts, owners);
+
+    // Load keys from threads of the owner node, so that values are in its memory too
+    std::vector<std::vector<std::string>> keys(numa.Nodes());
+    for (int i = 0; i < nkeys; i++) {
+        std::string key = "key" + std::to_string(i);
+        keys[storage.NodeOf(key)].push_back(key);
+    }
+    for (std::size_t node = 0; node < numa.Nodes(); node++) {
+        std::thread([&, node]() {
+            numa.Bind(node);
+            for (auto &key : keys[node]) {
+                storage.Put(key, "value-" + key);
+            }
+        }).join();
+    }
+
+    const int64_t total = int64_t(numa.Nodes()) * per_node * ops;
+    report("unrouted", total, run(storage, numa, per_node, ops, keys, false));
+    report("routed", total, run(storage, numa, per_node, ops, keys, true));
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/FlatCombineLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Runs mix of Get/Put from several threads over the storage with hot working set and reports
+ * throughput of each thread safe storage implementation.
+ *
+ * Usage: runStorageBench [threads] [ops_per_thread] [keys] [get_ratio_percent]
+ */
+
+static double run(Storage &storage, int threads, int ops, int keys, int get_ratio) {
+    std::vector<std::string> names;
+    for (int i = 0; i < keys; i++) {
+        names.push_back("key" + std::to_string(i));
+        storage.Put(names.back(), "value" + std::to_string(i));
+    }
+
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::minstd_rand rnd(t + 1);
+            std::string value;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < ops; i++) {
+                const std::string &key = names[rnd() % keys];
+                if (int(rnd() % 100) < get_ratio) {
+                    storage.Get(key, value);
+                } else {
+                    storage.Put(key, key);
+                }
+            }
+        });
+    }
+
+    auto started = Clock::now();
+    go.store(true);
+    for (auto &w : workers) {
+        w.join();
+    }
+    return std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+static void report(const std::string &name, int total, double sec) {
+    std::cout << name << ": " << total << " ops in " << sec << "s, " << static_cast<int64_t>(total / sec) << " ops/s"
+              << std::endl;
+}
+
+int main(int argc, char **argv) {
+    const int threads = argc > 1 ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+    const int ops = argc > 2 ? std::atoi(argv[2]) : 200000;
+    const int keys = argc > 3 ? std::atoi(argv[3]) : 10000;
+    const int get_ratio = argc > 4 ? std::atoi(argv[4]) : 90;
+    const std::size_t memory = 64 * 1024 * 1024;
+
+    {
+        Backend::ThreadSafeSimplLRU storage(memory, keys);
+        report("mt_lru", threads * ops, run(storage, threads, ops, keys, get_ratio));
+    }
+    {
+        Backend::FlatCombineLRU storage(memory, keys);
+        report("fc_lru", threads * ops, run(storage, threads, ops, keys, get_ratio));
+    }
+    return 0;
+}
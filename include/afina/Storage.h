@@ -1,7 +1,10 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Afina {
 
@@ -84,6 +87,75 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Looks several keys up at once, so that implementation could take its locks once for all of
+     * them rather than once per key. Default implementation calls Get for every key
+     *
+     * @param keys to retrieve values for
+     * @param values output parameter, resized to the number of keys, values[i] gets value of keys[i]
+     * @param found output parameter, resized to the number of keys, found[i] tells if keys[i] exists
+     */
+    virtual void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                         std::vector<bool> &found) {
+        values.resize(keys.size());
+        found.resize(keys.size());
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            found[i] = Get(*keys[i], values[i]);
+        }
+    }
+
+    /**
+     * Appends storage statistics as name/value pairs, reported by the "stats" command
+     *
+     * @param stats output parameter to append statistics to
+     */
+    virtual void Stats(std::vector<std::pair<std::string, std::string>> &stats) {}
+
+    /**
+     * NUMA node whose memory holds the given key, so that request could be served by thread running
+     * on that node
+     *
+     * @param key to find owner of
+     * @return node index or -1 if storage isn't node aware
+     */
+    virtual int NodeOf(const std::string &key) const { return -1; }
+
+    // Receives entries of the storage, see ForEach
+    using Visitor = std::function<void(const std::string &key, const std::string &value)>;
+
+    /**
+     * Calls visitor for every entry, from the least to the most recently used one. Not synchronized
+     * with other operations: caller must make sure storage isn't modified meanwhile, for example by
+     * running it in a process forked under Quiesce
+     *
+     * @param visitor to call for entries
+     */
+    virtual void ForEach(const Visitor &visitor) {}
+
+    /**
+     * Runs given function while no other operation is in progress and none could start until it
+     * returns, so that storage is consistent at any moment of the call
+     *
+     * @param f function to run
+     */
+    virtual void Quiesce(const std::function<void()> &f) { f(); }
+
+    /**
+     * Whether Quiesce really holds other operations off. Storage without own synchronization runs f
+     * right away, so it couldn't be snapshotted while being served
+     */
+    virtual bool CanQuiesce() const { return false; }
+
+    /**
+     * Adds entry loaded from snapshot as the most recently used one. Key must not be present in
+     * storage, so implementation could skip lookup and LRU reordering
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @return false if entry doesn't fit
+     */
+    virtual bool Restore(const std::string &key, const std::string &value) { return PutIfAbsent(key, value); }
 };
 
 } // namespace Afina
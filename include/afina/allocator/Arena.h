@@ -0,0 +1,85 @@
+#ifndef AFINA_ALLOCATOR_ARENA_H
+#define AFINA_ALLOCATOR_ARENA_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include <afina/allocator/Pages.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Source of slabs
+ * Maps memory from the system in large chunks and cuts them into slabs of kSlabSize bytes, each
+ * aligned to its size, so owner of any address inside slab could be found by masking low bits.
+ * Memory goes back to the system only when arena gets destroyed.
+ *
+ * Chunks could be backed by huge pages, which saves TLB misses on random access over large
+ * amount of memory, see PagePolicy.
+ *
+ * Thread safe, but expected to be called rarely: once per slab
+ */
+class Arena {
+public:
+    static constexpr std::size_t kSlabSize = 64 * 1024;
+
+    /**
+     * @param chunk_size number of bytes requested from the system at once, rounded up to kSlabSize
+     * @param policy pages to back chunks with
+     */
+    Arena(std::size_t chunk_size = 64 * kSlabSize, const PagePolicy &policy = PagePolicy());
+    ~Arena();
+
+    /**
+     * Returns new slab, throws AllocError(NoMemory) if system refused to give more memory
+     */
+    void *Map();
+
+    /**
+     * Number of bytes taken from the system
+     */
+    std::size_t Mapped();
+
+    /**
+     * Number of bytes taken from the system and backed by pages of the given kind
+     */
+    std::size_t Mapped(PageKind kind);
+
+    /**
+     * Changes pages used for next chunks and maps one right away, so that caller learns what system
+     * could really give. Returns kind of pages obtained
+     */
+    PageKind SetPolicy(const PagePolicy &policy);
+
+    /**
+     * Process wide arena, never destroyed
+     */
+    static Arena &Default();
+
+private:
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Maps new chunk and makes it current, called with lock held
+    void _grow();
+
+    const std::size_t _chunk_size;
+
+    std::mutex _mutex;
+
+    PagePolicy _policy;
+
+    // Chunks mapped from the system
+    std::vector<Mapping> _chunks;
+
+    // Not yet used part of the last chunk
+    char *_next;
+    char *_end;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ARENA_H
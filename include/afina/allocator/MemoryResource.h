@@ -0,0 +1,93 @@
+#ifndef AFINA_ALLOCATOR_MEMORY_RESOURCE_H
+#define AFINA_ALLOCATOR_MEMORY_RESOURCE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Polymorphic source of memory
+ * Mirrors std::pmr::memory_resource which is not available in C++11: containers get memory through
+ * StdAllocator pointing to some resource, so the same container type could work on top of different
+ * allocators and resources could be stacked (counting over pools over new/delete, etc).
+ */
+class MemoryResource {
+public:
+    static constexpr std::size_t kMaxAlign = alignof(std::max_align_t);
+
+    virtual ~MemoryResource() {}
+
+    /**
+     * Returns memory of at least bytes size, throws std::bad_alloc on failure
+     */
+    void *allocate(std::size_t bytes, std::size_t alignment = kMaxAlign) { return do_allocate(bytes, alignment); }
+
+    /**
+     * Gives memory back, bytes and alignment must be the same as passed to allocate
+     */
+    void deallocate(void *p, std::size_t bytes, std::size_t alignment = kMaxAlign) {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    /**
+     * Number of bytes request of the given size really takes, including allocator rounding and headers
+     */
+    std::size_t footprint(std::size_t bytes, std::size_t alignment = kMaxAlign) const {
+        return do_footprint(bytes, alignment);
+    }
+
+    /**
+     * True if memory allocated from one resource could be deallocated by the other one
+     */
+    bool is_equal(const MemoryResource &other) const noexcept { return this == &other || do_is_equal(other); }
+
+protected:
+    virtual void *do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) = 0;
+    virtual bool do_is_equal(const MemoryResource &other) const noexcept { return false; }
+    virtual std::size_t do_footprint(std::size_t bytes, std::size_t alignment) const { return bytes; }
+};
+
+/**
+ * Resource on the top of global operator new/delete, never destroyed
+ */
+MemoryResource *NewDeleteResource();
+
+/**
+ * # Accounting resource
+ * Forwards requests to upstream and keeps track of bytes currently allocated through it, as told by
+ * upstream footprint. If limit is set, requests going beyond it fail with std::bad_alloc
+ */
+class CountingResource : public MemoryResource {
+public:
+    CountingResource(MemoryResource *upstream = NewDeleteResource(), std::size_t limit = 0)
+        : _upstream(upstream), _limit(limit), _allocated(0) {}
+
+    /**
+     * Bytes allocated and not yet deallocated
+     */
+    std::size_t allocated() const { return _allocated.load(std::memory_order_relaxed); }
+
+    std::size_t limit() const { return _limit; }
+
+    MemoryResource *upstream() const { return _upstream; }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    std::size_t do_footprint(std::size_t bytes, std::size_t alignment) const override {
+        return _upstream->footprint(bytes, alignment);
+    }
+
+private:
+    MemoryResource *const _upstream;
+    const std::size_t _limit;
+    std::atomic<std::size_t> _allocated;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEMORY_RESOURCE_H
@@ -0,0 +1,106 @@
+#ifndef AFINA_ALLOCATOR_MEMPOOL_H
+#define AFINA_ALLOCATOR_MEMPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include <afina/allocator/SlabCache.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Pool of fixed size objects
+ * Objects are cut out of slabs taken from the slab cache. Each thread keeps its own list of free
+ * objects, so Alloc/Free normally touch no shared state; excess is moved to the shared depot in
+ * batches and taken back from there once thread list runs empty. List of the exiting thread goes to
+ * the depot as well.
+ *
+ * Slabs return to the slab cache only when pool is destroyed, all objects must be freed by then
+ */
+class Mempool {
+public:
+    // Max number of objects moved between thread cache and depot at once, large objects are moved
+    // by as many as fit into one slab
+    static constexpr std::size_t kBatch = 32;
+
+    /**
+     * @param object_size size of each object, must not exceed slab size
+     */
+    Mempool(std::size_t object_size, SlabCache &slabs = SlabCache::Default());
+    ~Mempool();
+
+    /**
+     * Returns memory for one object aligned to max_align_t
+     */
+    void *Alloc();
+
+    /**
+     * Returns object memory back to the pool, could be called by any thread
+     */
+    void Free(void *ptr);
+
+    /**
+     * Takes slabs in advance, so that count objects could be allocated without going to the
+     * slab cache
+     */
+    void Reserve(std::size_t count);
+
+    std::size_t ObjectSize() const { return _object_size; }
+
+    /**
+     * Number of slabs taken by the pool
+     */
+    std::size_t Slabs();
+
+private:
+    Mempool(const Mempool &) = delete;
+    Mempool &operator=(const Mempool &) = delete;
+
+    struct FreeObject {
+        FreeObject *next;
+    };
+
+    // Free objects linked through FreeObject::next
+    struct Chain {
+        FreeObject *head;
+        std::size_t size;
+    };
+
+    // Free objects owned by one thread
+    struct Cache {
+        Cache() : head(nullptr), size(0) {}
+
+        FreeObject *head;
+        std::size_t size;
+    };
+
+    // Moves one batch from cache to the depot
+    void _flush(Cache &cache);
+
+    // Fills empty cache from the depot or a new slab
+    void _refill(Cache &cache);
+
+    // Cuts new slab into chains in the depot, called with lock held
+    void _carve();
+
+    const std::size_t _object_size;
+    const std::size_t _batch;
+    SlabCache &_slabs;
+
+    // Depot: chains of _batch objects (shorter ones are left by exited threads), number of objects
+    // in them and all slabs owned by the pool
+    std::mutex _mutex;
+    std::vector<Chain> _chains;
+    std::size_t _free;
+    std::vector<void *> _owned;
+
+    Concurrency::ThreadLocal<Cache> _caches;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEMPOOL_H
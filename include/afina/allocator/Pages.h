@@ -0,0 +1,92 @@
+#ifndef AFINA_ALLOCATOR_PAGES_H
+#define AFINA_ALLOCATOR_PAGES_H
+
+#include <cstddef>
+#include <string>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * Kind of pages backing mapped memory
+ */
+enum class PageKind {
+    // Regular 4K pages
+    Normal,
+
+    // Regular mapping advised to be backed by transparent huge pages (MADV_HUGEPAGE), kernel
+    // collapses it into huge pages when it can
+    Transparent,
+
+    // Explicit huge pages from the hugetlbfs pool (MAP_HUGETLB), must be reserved by admin
+    Huge,
+};
+
+/**
+ * How memory should be taken from the system
+ */
+struct PagePolicy {
+    PagePolicy(PageKind k = PageKind::Normal, bool p = false, int n = -1) : kind(k), populate(p), node(n) {}
+
+    // Preferred kind, weaker ones are used if the system can't provide it
+    PageKind kind;
+
+    // Prefault whole mapping upfront, so that first touch doesn't stall on page fault
+    bool populate;
+
+    // NUMA node memory should come from, -1 for any. Kernel falls back to other nodes if the
+    // preferred one runs out of memory
+    int node;
+};
+
+/**
+ * Size of a huge page, 2M on x86_64
+ */
+constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+/**
+ * # Anonymous memory mapping
+ * Tries pages of the kind requested by policy, falling back to Transparent and then to Normal
+ * ones. Kind that was obtained is reported by kind(). Unmapped on destruction
+ */
+class Mapping {
+public:
+    Mapping() : _addr(nullptr), _len(0), _kind(PageKind::Normal) {}
+
+    /**
+     * Maps at least len bytes aligned to align (power of two), throws AllocError(NoMemory) on
+     * failure. Explicit huge pages mapping is rounded up to the huge page size
+     */
+    Mapping(std::size_t len, std::size_t align, const PagePolicy &policy);
+    ~Mapping();
+
+    Mapping(Mapping &&other);
+    Mapping &operator=(Mapping &&other);
+
+    char *data() const { return static_cast<char *>(_addr); }
+    std::size_t size() const { return _len; }
+    PageKind kind() const { return _kind; }
+
+private:
+    Mapping(const Mapping &) = delete;
+    Mapping &operator=(const Mapping &) = delete;
+
+    void *_addr;
+    std::size_t _len;
+    PageKind _kind;
+};
+
+/**
+ * Parses page kind name: off, thp or on
+ */
+PageKind ParsePageKind(const std::string &name);
+
+/**
+ * Human readable name of the page kind
+ */
+const char *PageKindName(PageKind kind);
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_PAGES_H
@@ -7,6 +7,13 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle of memory block allocated by Simple. Pointer refers to the slot in allocator's handle
+ * table rather than to the block itself, so allocator is free to move block around. Copies of the
+ * pointer share the same slot.
+ *
+ * Address returned by get() is valid only until the next call to allocator
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +24,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _handle != nullptr ? *_handle : nullptr; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **handle);
+
+    // Slot in the handle table holding current address of the block
+    void **_handle;
 };
 
 } // namespace Allocator
@@ -0,0 +1,59 @@
+#ifndef AFINA_ALLOCATOR_POOL_RESOURCE_H
+#define AFINA_ALLOCATOR_POOL_RESOURCE_H
+
+#include <memory>
+#include <vector>
+
+#include <afina/allocator/MemoryResource.h>
+#include <afina/allocator/Mempool.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Size class allocator
+ * Small requests are rounded up to the nearest size class and served by the mempool of that class,
+ * so objects of similar size share slabs and malloc isn't involved at all. Large and over aligned
+ * requests go to the upstream resource.
+ */
+class PoolResource : public MemoryResource {
+public:
+    // Requests above that size go to upstream
+    static constexpr std::size_t kMaxPooled = 4096;
+
+    PoolResource(MemoryResource *upstream = NewDeleteResource(), SlabCache &slabs = SlabCache::Default());
+
+    /**
+     * Number of bytes actually taken for the request of the given size, including rounding up to
+     * the size class
+     */
+    static std::size_t Rounded(std::size_t bytes);
+
+    /**
+     * Prepares memory for count requests of the given size in advance, no-op for sizes served
+     * by upstream
+     */
+    void Reserve(std::size_t bytes, std::size_t count);
+
+    /**
+     * Process wide pools on the top of the default slab cache, never destroyed
+     */
+    static PoolResource &Default();
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    std::size_t do_footprint(std::size_t bytes, std::size_t alignment) const override;
+
+private:
+    // Index of the size class for request of size bytes <= kMaxPooled
+    static std::size_t _class(std::size_t bytes);
+
+    MemoryResource *const _upstream;
+    std::vector<std::unique_ptr<Mempool>> _pools;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_POOL_RESOURCE_H
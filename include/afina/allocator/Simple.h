@@ -1,8 +1,8 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
-#include <string>
 #include <cstddef>
+#include <string>
 
 namespace Afina {
 namespace Allocator {
@@ -18,6 +18,10 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Blocks grow from the beginning of the area, each one prefixed by small header. Table of handles
+ * grows from the end of the area towards blocks; Pointer refers to the handle, so blocks could be
+ * moved by defrag() without invalidating pointers held by users.
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
@@ -25,37 +29,78 @@ public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes. Throws AllocError(NoMemory) if there is no free block
+     * large enough, call defrag() and retry to use all free space.
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block keeping its content up to min(old size, N). Shrinks and grows in
+     * place if possible, otherwise moves block to a new location. Empty pointer gets a new block.
+     * On failure throws AllocError(NoMemory) leaving original block untouched
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Returns block back to the allocator and resets p. Empty pointer is ignored, pointer not
+     * owned by this allocator causes AllocError(InvalidFree). Copies of p become dangling
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all allocated blocks to the beginning of the area, so all free space forms single
+     * block. Addresses of blocks change, pointers stay valid
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Largest N alloc() could satisfy in the empty area, once block header and handle are taken out.
+     * Requests above it never fit no matter how much is freed
+     */
+    size_t max_size() const;
+
+    /**
+     * Human readable layout of the area: list of blocks and handle table usage
      */
     std::string dump() const;
 
 private:
+    // Header of each block, payload follows right after it
+    struct Block;
+
+    // Returns block of at least size bytes from the free ones, nullptr if there is no such block
+    Block *_find_free(size_t size);
+
+    // Cuts tail of the block beyond size into a separate free block
+    void _split(Block *block, size_t size);
+
+    // Joins block with free blocks following it
+    void _merge_next(Block *block);
+
+    // Marks block free and trims area if it was the last one
+    void _release(Block *block);
+
+    // Slot in the handle table, grows table if there is no free one
+    void **_take_handle();
+    void _release_handle(void **handle);
+
+    Block *_next(Block *block) const;
+
     void *_base;
     const size_t _base_len;
+
+    // Blocks area: [_begin, _top)
+    char *_begin;
+    char *_top;
+
+    // Handle table: [_handles, _end), free slots are linked through their values
+    void **_handles;
+    void **_end;
+    void **_free_handles;
 };
 
 } // namespace Allocator
@@ -0,0 +1,65 @@
+#ifndef AFINA_ALLOCATOR_SLAB_CACHE_H
+#define AFINA_ALLOCATOR_SLAB_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <afina/allocator/Arena.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Cache of free slabs
+ * Slabs released by pools are kept here and handed out to other pools before asking arena for
+ * more memory. Free slabs are linked into lock-free stack, the link lives in the slab itself;
+ * ABA is prevented by the tag packed into low bits of the head, which are always zero for slab
+ * aligned addresses.
+ */
+class SlabCache {
+public:
+    SlabCache(Arena &arena) : _arena(arena), _free(0), _cached(0) {}
+
+    /**
+     * Returns slab of Arena::kSlabSize bytes
+     */
+    void *Get();
+
+    /**
+     * Gives slab back to the cache
+     */
+    void Put(void *slab);
+
+    /**
+     * Number of free slabs in the cache
+     */
+    std::size_t Cached() const { return _cached.load(std::memory_order_relaxed); }
+
+    /**
+     * Process wide cache on the top of the default arena, never destroyed
+     */
+    static SlabCache &Default();
+
+private:
+    SlabCache(const SlabCache &) = delete;
+    SlabCache &operator=(const SlabCache &) = delete;
+
+    struct FreeSlab {
+        FreeSlab *next;
+    };
+
+    // Bits of the head used by tag
+    static constexpr uintptr_t kTagMask = Arena::kSlabSize - 1;
+
+    Arena &_arena;
+
+    // Top of the stack: slab address | tag
+    std::atomic<uintptr_t> _free;
+    std::atomic<std::size_t> _cached;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_CACHE_H
@@ -0,0 +1,57 @@
+#ifndef AFINA_ALLOCATOR_STD_ALLOCATOR_H
+#define AFINA_ALLOCATOR_STD_ALLOCATOR_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include <afina/allocator/MemoryResource.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Standard allocator on the top of MemoryResource
+ * Satisfies Allocator requirements, so could be used with any STL container via allocator_traits.
+ * Allocator is stateful and travels together with container content on copy/move assignment and
+ * swap, so memory always goes back to the resource it was taken from.
+ */
+template <typename T> class StdAllocator {
+public:
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    StdAllocator(MemoryResource *resource = NewDeleteResource()) noexcept : _resource(resource) {}
+
+    template <typename U> StdAllocator(const StdAllocator<U> &other) noexcept : _resource(other.resource()) {}
+
+    T *allocate(std::size_t n) { return static_cast<T *>(_resource->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T *p, std::size_t n) { _resource->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    MemoryResource *resource() const noexcept { return _resource; }
+
+private:
+    MemoryResource *_resource;
+};
+
+template <typename T, typename U> bool operator==(const StdAllocator<T> &a, const StdAllocator<U> &b) noexcept {
+    return a.resource()->is_equal(*b.resource());
+}
+
+template <typename T, typename U> bool operator!=(const StdAllocator<T> &a, const StdAllocator<U> &b) noexcept {
+    return !(a == b);
+}
+
+/**
+ * String taking memory from the resource
+ */
+using String = std::basic_string<char, std::char_traits<char>, StdAllocator<char>>;
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_STD_ALLOCATOR_H
@@ -0,0 +1,38 @@
+#ifndef AFINA_CONCURRENCY_CACHE_ALIGNED_H
+#define AFINA_CONCURRENCY_CACHE_ALIGNED_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Base for types aligned to cache line
+ * C++11 operator new ignores alignas beyond alignof(max_align_t), so objects with padded members
+ * could land in the middle of a cache line and compiler is free to use aligned vector instructions
+ * on them. Deriving from this class makes new/new[] honor the alignment
+ */
+struct CacheAligned {
+    static constexpr std::size_t kCacheLine = 64;
+
+    static void *operator new(std::size_t size) { return _allocate(size); }
+    static void *operator new[](std::size_t size) { return _allocate(size); }
+    static void operator delete(void *ptr) noexcept { std::free(ptr); }
+    static void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+private:
+    static void *_allocate(std::size_t size) {
+        void *ptr = nullptr;
+        if (posix_memalign(&ptr, kCacheLine, size) != 0) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_CACHE_ALIGNED_H
@@ -1,10 +1,112 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <sched.h>
+#include <sys/sysinfo.h>
+
+#include <afina/concurrency/CacheAligned.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Per CPU storage
+ * Keeps one instance of T per configured CPU, each in its own cache line. Thread selects instance
+ * of the CPU it is running on at the moment (sched_getcpu is served by vDSO/rseq, no syscall).
+ *
+ * Thread could be migrated or preempted right after it got the instance, so T must tolerate
+ * concurrent access: typically it is an atomic updated with relaxed ordering, which is cheap as
+ * long as cache line stays on the same core, or something protected by own lock.
+ */
+template <typename T> class CoreLocal {
+public:
+    CoreLocal() : _ncpu(cpus()), _cells(new Cell[_ncpu]()) {}
+
+    /**
+     * Instance of the CPU current thread is running on
+     */
+    T &local() { return _cells[current() % _ncpu].value; }
+
+    /**
+     * Instance of the given CPU
+     */
+    T &at(std::size_t cpu) { return _cells[cpu % _ncpu].value; }
+
+    /**
+     * Number of instances
+     */
+    std::size_t size() const { return _ncpu; }
+
+    /**
+     * Calls f(T&) for instances of all CPUs
+     */
+    template <typename F> void for_each(F f) {
+        for (std::size_t i = 0; i < _ncpu; i++) {
+            f(_cells[i].value);
+        }
+    }
+
+    /**
+     * Folds instances of all CPUs: result = f(result, T&)
+     */
+    template <typename R, typename F> R aggregate(R init, F f) {
+        for (std::size_t i = 0; i < _ncpu; i++) {
+            init = f(init, _cells[i].value);
+        }
+        return init;
+    }
+
+    /**
+     * Index of the CPU current thread is running on
+     */
+    static std::size_t current() {
+        int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : static_cast<std::size_t>(cpu);
+    }
+
+    /**
+     * Number of configured CPUs, including offline ones since they could come up later
+     */
+    static std::size_t cpus() {
+        int n = get_nprocs_conf();
+        return n > 0 ? static_cast<std::size_t>(n) : 1;
+    }
+
+private:
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+
+    // Padded to avoid false sharing between neighbour CPUs
+    struct alignas(64) Cell : CacheAligned {
+        T value;
+    };
+
+    const std::size_t _ncpu;
+    std::unique_ptr<Cell[]> _cells;
+};
+
+/**
+ * # Per CPU counter
+ * Increments touch only the cache line of the current CPU, reads sum over all of them
+ */
+class CoreCounter {
+public:
+    void Add(int64_t delta = 1) { _cells.local().fetch_add(delta, std::memory_order_relaxed); }
+
+    int64_t Get() {
+        return _cells.aggregate(int64_t(0), [](int64_t sum, std::atomic<int64_t> &cell) {
+            return sum + cell.load(std::memory_order_relaxed);
+        });
+    }
+
+private:
+    CoreLocal<std::atomic<int64_t>> _cells;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -1,23 +1,31 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
-#include <chrono>
-#include <algorithm>
+
+#include <afina/concurrency/Task.h>
 
 namespace Afina {
 namespace Concurrency {
 
+// Forward declaration, see TaskPool.h
+struct TaskNode;
+
 /**
  * # Thread pool
+ * Pool keeps at least low_watermark threads alive and spawns new ones up to high_watermark in case if
+ * all existing threads are busy. Threads above low_watermark exit once they were idle for idle_time
+ * milliseconds. Task queue is bounded by max_queue_size, what happens with tasks that doesn't fit is
+ * defined by the rejection policy.
  */
 class Executor {
+public:
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -29,22 +37,30 @@ class Executor {
         // Threadppol is stopped
         kStopped,
 
-        // why not?
+        // Threadpool is created, but not started yet
         kReady
     };
 
-    Executor(std::string name, int size, int _low, int _high, int _time)
-        : _max_queue_size(size)
-        , _high_watermark(_high)
-        , _low_watermark(_low)
-        , _idle_time(_time)
-        , state(State::kReady)
-    { }
+    /**
+     * What to do with the task in case if queue is full
+     */
+    enum class Rejection {
+        // Execute returns false, task is dropped
+        kReject,
 
-    ~Executor();
+        // Task gets executed right on the calling thread, that slows producer down
+        kCallerRuns
+    };
 
+    Executor(std::string name, std::size_t max_queue_size, std::size_t low_watermark, std::size_t high_watermark,
+             std::size_t idle_time, Rejection policy = Rejection::kReject);
+    ~Executor();
 
+    /**
+     * Spawns low_watermark threads and allows tasks to be added
+     */
     void Start();
+
     /**
      * Signal thread pool to stop, it will stop accepting new jobs and close threads just after each become
      * free. All enqueued jobs will be complete.
@@ -61,36 +77,52 @@ class Executor {
      * execution finished by itself
      */
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
-        // Prepare "task"
-        auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
-        {
-            std::unique_lock<std::mutex> lock(this->mutex);
-            if (state != State::kRun || tasks.size() >= _max_queue_size) {
-                return false;
-            } //
-
-            // Enqueue new task
-            tasks.push_back(exec);
-            if (_free_threads == 0 && threads.size() >= _max_queue_size)
-                return false;
-
-            empty_condition.notify_one();
-        }
-        return true;
+        // Prepare "task", closures up to Task::kInlineSize don't touch the heap
+        return _enqueue(Task(std::bind(std::forward<F>(func), std::forward<Types>(args)...)));
     }
 
+    /**
+     * Current state of the pool
+     */
+    State GetState();
+
+    /**
+     * Number of threads alive at the moment, both busy and idle
+     */
+    std::size_t Threads();
+
+    /**
+     * Number of tasks waiting in the queue
+     */
+    std::size_t Queued();
+
 private:
     // No copy/move/assign allowed
-    Executor(const Executor &);            // = delete;
-    Executor(Executor &&);                 // = delete;
-    Executor &operator=(const Executor &); // = delete;
-    Executor &operator=(Executor &&);      // = delete;
+    Executor(const Executor &) = delete;
+    Executor(Executor &&) = delete;
+    Executor &operator=(const Executor &) = delete;
+    Executor &operator=(Executor &&) = delete;
 
     /**
      * Main function that all pool threads are running. It polls internal task queue and execute tasks
      */
     friend void perform(Executor *executor);
 
+    /**
+     * Places task onto queue or applies rejection policy
+     */
+    bool _enqueue(Task &&task);
+
+    /**
+     * Spawns new thread, must be called with mutex held
+     */
+    void _add_thread();
+
+    /**
+     * Pool name, used for diagnostics only
+     */
+    const std::string _name;
+
     /**
      * Mutex to protect state below from concurrent modification
      */
@@ -102,32 +134,34 @@ private:
     std::condition_variable empty_condition;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await for the last thread to exit
      */
-    std::vector<std::thread> threads;
+    std::condition_variable _cv_stopping;
 
     /**
-     * Task queue
+     * Task queue, intrusive list of pooled nodes
      */
-    std::deque<std::function<void()>> tasks;
+    TaskNode *_tasks_head;
+    TaskNode *_tasks_tail;
+    std::size_t _tasks_size;
 
     /**
      * Flag to stop bg threads
      */
     State state;
 
-    /*
-     * My stuff
-     */
-    const int _low_watermark;
-    const int _high_watermark;
-    const int _max_queue_size;
-    const int _idle_time;
-    int _free_threads;
-    std::condition_variable _cv_stopping;
+    // Pool sizing configuration
+    const std::size_t _max_queue_size;
+    const std::size_t _low_watermark;
+    const std::size_t _high_watermark;
+    const std::chrono::milliseconds _idle_time;
+    const Rejection _policy;
 
-    void _add_thread();
-    void _erase_thread();
+    // Number of threads alive
+    std::size_t _threads;
+
+    // Number of threads waiting for a task, including just spawned ones
+    std::size_t _free_threads;
 };
 
 } // namespace Concurrency
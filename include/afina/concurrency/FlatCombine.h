@@ -1,10 +1,149 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CacheAligned.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Instead of each thread taking the lock to apply its own operation, threads publish operations
+ * in the per-thread slots and one of them (combiner) takes the lock and applies all published
+ * operations in a batch. Protected data stays hot in the combiner's cache and lock cache line
+ * doesn't bounce between cores on every operation.
+ *
+ * Op is arbitrary type describing operation and place for its result, FlatCombine never looks
+ * inside. Combiner function gets array of pending operations and must execute all of them. It should
+ * keep exception of an operation in the Op for its owner to rethrow; if combiner throws anyway, every
+ * operation of the batch is failed with that exception and the combiner lock is released.
+ */
+template <typename Op> class FlatCombine {
+public:
+    // Executes batch of operations, called by one thread at a time
+    using Combiner = std::function<void(Op **ops, std::size_t count)>;
+
+    // Max number of passes over publication slots by one combiner before it leaves
+    static constexpr int kMaxPasses = 4;
+
+    FlatCombine(Combiner combiner, std::size_t slots = 0)
+        : _combiner(std::move(combiner)), _nslots(slots > 0 ? slots : 2 * std::thread::hardware_concurrency() + 2),
+          _slots(new Slot[_nslots]) {
+        _batch.reserve(_nslots);
+        _batch_slots.reserve(_nslots);
+    }
+
+    /**
+     * Publishes operation and blocks until some combiner (possibly current thread) executes it.
+     * Rethrows exception of the combiner which failed the batch with this operation
+     */
+    void Execute(Op &op) {
+        Pending pending(&op);
+        Slot &slot = _publish(&pending);
+        for (int spins = 0; slot.pending.load(std::memory_order_acquire) == &pending; spins++) {
+            std::unique_lock<std::mutex> lock(_lock, std::try_to_lock);
+            if (lock.owns_lock()) {
+                _combine();
+            } else if (spins > 16) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (pending.error) {
+            std::rethrow_exception(pending.error);
+        }
+    }
+
+private:
+    FlatCombine(const FlatCombine &) = delete;
+    FlatCombine &operator=(const FlatCombine &) = delete;
+
+    // Published operation, lives on the stack of its owner
+    struct Pending {
+        explicit Pending(Op *o) : op(o) {}
+        Op *const op;
+        std::exception_ptr error;
+    };
+
+    // Publication slot, holds pointer to the pending operation or nullptr once it is free
+    struct alignas(64) Slot : CacheAligned {
+        Slot() : pending(nullptr) {}
+        std::atomic<Pending *> pending;
+    };
+
+    // Finds free slot, starting from the one assigned to the current thread
+    Slot &_publish(Pending *pending) {
+        static std::atomic<std::size_t> next_id(0);
+        static thread_local std::size_t id = next_id.fetch_add(1);
+
+        for (std::size_t i = id % _nslots;; i = (i + 1) % _nslots) {
+            Pending *expected = nullptr;
+            if (_slots[i].pending.load(std::memory_order_relaxed) == nullptr &&
+                _slots[i].pending.compare_exchange_strong(expected, pending, std::memory_order_release)) {
+                return _slots[i];
+            }
+            if (i + 1 == _nslots) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Executes published operations, called with lock held
+    void _combine() {
+        for (int pass = 0; pass < kMaxPasses; pass++) {
+            _batch.clear();
+            _batch_slots.clear();
+            for (std::size_t i = 0; i < _nslots; i++) {
+                Pending *pending = _slots[i].pending.load(std::memory_order_acquire);
+                if (pending != nullptr) {
+                    _batch.push_back(pending->op);
+                    _batch_slots.push_back(&_slots[i]);
+                }
+            }
+
+            if (_batch.empty()) {
+                return;
+            }
+
+            try {
+                _combiner(_batch.data(), _batch.size());
+            } catch (...) {
+                std::exception_ptr error = std::current_exception();
+                for (Slot *slot : _batch_slots) {
+                    slot->pending.load(std::memory_order_relaxed)->error = error;
+                }
+            }
+
+            // Let owners know their operations are done and slots are free
+            for (Slot *slot : _batch_slots) {
+                slot->pending.store(nullptr, std::memory_order_release);
+            }
+        }
+    }
+
+    const Combiner _combiner;
+
+    // Lock protecting combiner role
+    std::mutex _lock;
+
+    // Publication list
+    const std::size_t _nslots;
+    std::unique_ptr<Slot[]> _slots;
+
+    // Combiner scratch space, protected by the lock
+    std::vector<Op *> _batch;
+    std::vector<Slot *> _batch_slots;
+};
+
+template <typename Op> constexpr int FlatCombine<Op>::kMaxPasses;
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,130 @@
+#ifndef AFINA_CONCURRENCY_HISTOGRAM_H
+#define AFINA_CONCURRENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Per CPU log-linear histogram
+ * HDR style buckets: every power of two range is split into kSubBuckets equal parts, so relative
+ * error of any percentile is below 1/kSubBuckets whatever the scale. Values below kSubBuckets are
+ * exact, values above 2^kMaxExponent land into the last bucket.
+ *
+ * Record is one relaxed increment on the cache line of the current CPU, readers sum buckets over
+ * all CPUs into a Snapshot.
+ */
+class Histogram {
+public:
+    static constexpr std::size_t kSubBuckets = 8;
+    static constexpr std::size_t kSubBits = 3;
+    static constexpr std::size_t kMaxExponent = 40;
+    static constexpr std::size_t kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+    // Consistent enough copy of all buckets
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> buckets{};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+
+        /**
+         * Upper bound of the bucket holding the given quantile (0..1), 0 if histogram is empty
+         */
+        uint64_t Percentile(double quantile) const {
+            if (count == 0) {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(quantile * count);
+            rank = rank >= count ? count - 1 : rank;
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < kBuckets; i++) {
+                seen += buckets[i];
+                if (seen > rank) {
+                    return UpperBound(i);
+                }
+            }
+            return UpperBound(kBuckets - 1);
+        }
+
+        /**
+         * Upper bound of the highest non empty bucket
+         */
+        uint64_t Max() const { return Percentile(1.0); }
+
+        /**
+         * Number of values in buckets lying entirely at or below the given bound, so it undercounts
+         * by at most one bucket, which is within 1/kSubBuckets of the bound
+         */
+        uint64_t CountBelow(uint64_t bound) const {
+            uint64_t result = 0;
+            for (std::size_t i = 0; i < kBuckets && UpperBound(i) <= bound; i++) {
+                result += buckets[i];
+            }
+            return result;
+        }
+    };
+
+    void Record(uint64_t value) {
+        Cell &cell = _cells.local();
+        cell.buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        cell.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    Snapshot Get() {
+        Snapshot result;
+        _cells.for_each([&result](Cell &cell) {
+            result.sum += cell.sum.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < kBuckets; i++) {
+                uint64_t n = cell.buckets[i].load(std::memory_order_relaxed);
+                result.buckets[i] += n;
+                result.count += n;
+            }
+        });
+        return result;
+    }
+
+    static std::size_t BucketOf(uint64_t value) {
+        if (value < kSubBuckets) {
+            return value;
+        }
+        std::size_t exponent = 63 - __builtin_clzll(value);
+        if (exponent > kMaxExponent) {
+            return kBuckets - 1;
+        }
+        std::size_t sub = (value >> (exponent - kSubBits)) & (kSubBuckets - 1);
+        return (exponent - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    // Smallest value of the bucket
+    static uint64_t LowerBound(std::size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        std::size_t exponent = bucket / kSubBuckets + kSubBits - 1;
+        return (kSubBuckets + bucket % kSubBuckets) << (exponent - kSubBits);
+    }
+
+    // Largest value of the bucket
+    static uint64_t UpperBound(std::size_t bucket) {
+        return bucket + 1 < kBuckets ? LowerBound(bucket + 1) - 1 : LowerBound(bucket);
+    }
+
+private:
+    struct Cell {
+        std::array<std::atomic<uint64_t>, kBuckets> buckets;
+        std::atomic<uint64_t> sum;
+    };
+
+    CoreLocal<Cell> _cells;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_HISTOGRAM_H
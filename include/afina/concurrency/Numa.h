@@ -0,0 +1,68 @@
+#ifndef AFINA_CONCURRENCY_NUMA_H
+#define AFINA_CONCURRENCY_NUMA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # NUMA topology
+ * Describes which CPUs belong to which node and lets threads stay on a node: run on its CPUs only and
+ * take memory from it. Nodes are numbered from 0 densely, each one knows the real node its memory
+ * comes from.
+ *
+ * Fake topology splits CPUs of the box into the given number of nodes, so that node aware code could
+ * be exercised on a single node machine. All fake nodes take memory from the real nodes round robin.
+ */
+class Topology {
+public:
+    struct Node {
+        // CPUs belonging to the node
+        std::vector<int> cpus;
+
+        // Real node memory comes from
+        int memory;
+    };
+
+    /**
+     * Reads topology of the machine from sysfs, single node with all CPUs if there is no NUMA
+     */
+    static Topology Detect();
+
+    /**
+     * Splits CPUs of the machine into the given number of nodes, round robin. If there are less CPUs
+     * than nodes, some CPUs belong to several nodes
+     */
+    static Topology Fake(std::size_t nodes);
+
+    std::size_t Nodes() const { return _nodes.size(); }
+
+    const Node &At(std::size_t node) const { return _nodes.at(node); }
+
+    bool IsFake() const { return _fake; }
+
+    /**
+     * Restricts calling thread to CPUs of the node and makes kernel prefer memory of the node for
+     * its allocations. Returns false if kernel refused any of that
+     */
+    bool Bind(std::size_t node) const;
+
+    /**
+     * Human readable description, like "2 nodes (fake): cpus 0 1 -> memory 0, cpus 2 3 -> memory 0"
+     */
+    std::string Describe() const;
+
+private:
+    Topology() : _fake(false) {}
+
+    std::vector<Node> _nodes;
+    bool _fake;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_NUMA_H
@@ -0,0 +1,143 @@
+#ifndef AFINA_CONCURRENCY_TASK_H
+#define AFINA_CONCURRENCY_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Move only callable
+ * Replacement of std::function<void()> for executor queues. Callables up to kInlineSize bytes are
+ * stored right inside of the task object, so that creating task for typical closure (couple of
+ * pointers, shared_ptr and a socket) doesn't touch the heap. Bigger ones fall back to new/delete.
+ *
+ * Unlike std::function, callable doesn't have to be copyable and task is never copied.
+ */
+class Task {
+public:
+    // Size of the inline storage
+    static constexpr std::size_t kInlineSize = 64;
+
+    Task() noexcept : _ops(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+    Task(F &&func) : _ops(nullptr) {
+        _init(std::forward<F>(func), Inline<typename std::decay<F>::type>());
+    }
+
+    Task(Task &&other) noexcept : _ops(other._ops) {
+        if (_ops != nullptr) {
+            _ops->move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            Reset();
+            if (other._ops != nullptr) {
+                _ops = other._ops;
+                _ops->move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ~Task() { Reset(); }
+
+    /**
+     * Destroys stored callable, task becomes empty
+     */
+    void Reset() noexcept {
+        if (_ops != nullptr) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+    /**
+     * True if task has a callable assigned
+     */
+    explicit operator bool() const noexcept { return _ops != nullptr; }
+
+    /**
+     * True if callable lives inside of the task object
+     */
+    bool IsInline() const noexcept { return _ops != nullptr && _ops->is_inline; }
+
+    /**
+     * Run stored callable, task must not be empty
+     */
+    void operator()() { _ops->invoke(&_storage); }
+
+private:
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    using Storage = typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type;
+
+    // Type erased operations over the storage
+    struct Ops {
+        void (*invoke)(Storage *);
+        void (*move)(Storage *dst, Storage *src);
+        void (*destroy)(Storage *);
+        bool is_inline;
+    };
+
+    template <typename Fn>
+    struct Inline
+        : std::integral_constant<bool, sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+                                           std::is_nothrow_move_constructible<Fn>::value> {};
+
+    template <typename Fn> struct InlineOps {
+        static Fn *get(Storage *s) { return reinterpret_cast<Fn *>(s); }
+        static void invoke(Storage *s) { (*get(s))(); }
+        static void move(Storage *dst, Storage *src) {
+            new (dst) Fn(std::move(*get(src)));
+            get(src)->~Fn();
+        }
+        static void destroy(Storage *s) { get(s)->~Fn(); }
+        static const Ops ops;
+    };
+
+    template <typename Fn> struct HeapOps {
+        static Fn *&get(Storage *s) { return *reinterpret_cast<Fn **>(s); }
+        static void invoke(Storage *s) { (*get(s))(); }
+        static void move(Storage *dst, Storage *src) { *reinterpret_cast<Fn **>(dst) = get(src); }
+        static void destroy(Storage *s) { delete get(s); }
+        static const Ops ops;
+    };
+
+    template <typename F> void _init(F &&func, std::true_type) {
+        using Fn = typename std::decay<F>::type;
+        new (&_storage) Fn(std::forward<F>(func));
+        _ops = &InlineOps<Fn>::ops;
+    }
+
+    template <typename F> void _init(F &&func, std::false_type) {
+        using Fn = typename std::decay<F>::type;
+        *reinterpret_cast<Fn **>(&_storage) = new Fn(std::forward<F>(func));
+        _ops = &HeapOps<Fn>::ops;
+    }
+
+    const Ops *_ops;
+    Storage _storage;
+};
+
+template <typename Fn>
+const Task::Ops Task::InlineOps<Fn>::ops = {&InlineOps<Fn>::invoke, &InlineOps<Fn>::move, &InlineOps<Fn>::destroy,
+                                            true};
+
+template <typename Fn>
+const Task::Ops Task::HeapOps<Fn>::ops = {&HeapOps<Fn>::invoke, &HeapOps<Fn>::move, &HeapOps<Fn>::destroy, false};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TASK_H
@@ -1,10 +1,304 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+/**
+ * # Thread local values of all ThreadLocal instances
+ * Every instance gets a small id, and each thread keeps a table of cells indexed by it. The table
+ * is found by a single pthread key shared by all instances, so their number isn't bound by
+ * PTHREAD_KEYS_MAX (which is shared with libc and other libraries) but by kMaxInstances. Ids are
+ * reused once their instance is destroyed.
+ *
+ * Table is split into fixed blocks which never move, so cells could be cleared by other threads
+ * while the owner grows its table.
+ */
+class ThreadSlots {
+public:
+    static constexpr std::size_t kBlock = 64;
+    static constexpr std::size_t kBlocks = 256;
+    static constexpr std::size_t kMaxInstances = kBlock * kBlocks;
+
+    // Value of one instance for one thread
+    struct Value {
+        virtual ~Value() {}
+
+        // Called on thread exit with Lock() held, must give value back to its instance and free it
+        virtual void Release() = 0;
+    };
+
+    using Cell = std::atomic<Value *>;
+
+    /**
+     * Allocates id for a new instance
+     */
+    static std::size_t Acquire() {
+        Registry &r = _registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free.empty()) {
+            std::size_t id = r.free.back();
+            r.free.pop_back();
+            return id;
+        }
+        if (r.next == kMaxInstances) {
+            throw std::runtime_error("Too many thread local instances");
+        }
+        return r.next++;
+    }
+
+    /**
+     * Gives id of the destroyed instance back, its cells of all threads must be cleared
+     */
+    static void Retire(std::size_t id) {
+        Registry &r = _registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free.push_back(id);
+    }
+
+    /**
+     * Held while values are released on thread exit and while instance is destroyed, so the two never race
+     */
+    static std::mutex &Lock() { return _registry().exit_mutex; }
+
+    /**
+     * Cell of the current thread for the instance id, nullptr if thread has none yet
+     */
+    static Cell *Find(std::size_t id) {
+        Table *table = static_cast<Table *>(pthread_getspecific(_key()));
+        if (table == nullptr) {
+            return nullptr;
+        }
+        Block *block = table->blocks[id / kBlock];
+        return block != nullptr ? &block->cells[id % kBlock] : nullptr;
+    }
+
+    /**
+     * Cell of the current thread for the instance id, table and block are allocated if needed
+     */
+    static Cell &Create(std::size_t id) {
+        Table *table = static_cast<Table *>(pthread_getspecific(_key()));
+        if (table == nullptr) {
+            table = new Table();
+            if (pthread_setspecific(_key(), table) != 0) {
+                delete table;
+                throw std::runtime_error("Failed to set thread local value");
+            }
+        }
+
+        Block *&block = table->blocks[id / kBlock];
+        if (block == nullptr) {
+            block = new Block();
+        }
+        return block->cells[id % kBlock];
+    }
+
+private:
+    struct Block {
+        Block() {
+            for (std::size_t i = 0; i < kBlock; i++) {
+                cells[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        Cell cells[kBlock];
+    };
+
+    struct Table {
+        Table() : blocks() {}
+        Block *blocks[kBlocks];
+    };
+
+    struct Registry {
+        Registry() : next(0) {
+            if (pthread_key_create(&_key(), &ThreadSlots::_exit) != 0) {
+                throw std::runtime_error("Failed to create thread local key");
+            }
+        }
+
+        // Protects ids
+        std::mutex mutex;
+        std::size_t next;
+        std::vector<std::size_t> free;
+
+        std::mutex exit_mutex;
+    };
+
+    // Never destroyed: threads could exit after static destructors
+    static Registry &_registry() {
+        static Registry *instance = new Registry();
+        return *instance;
+    }
+
+    // Valid once the first id is acquired
+    static pthread_key_t &_key() {
+        static pthread_key_t key;
+        return key;
+    }
+
+    // Called by pthread on thread exit
+    static void _exit(void *ptr) {
+        Table *table = static_cast<Table *>(ptr);
+        {
+            std::lock_guard<std::mutex> lock(Lock());
+            for (std::size_t b = 0; b < kBlocks; b++) {
+                Block *block = table->blocks[b];
+                for (std::size_t i = 0; block != nullptr && i < kBlock; i++) {
+                    Value *value = block->cells[i].exchange(nullptr, std::memory_order_relaxed);
+                    if (value != nullptr) {
+                        value->Release();
+                    }
+                }
+            }
+        }
+
+        for (std::size_t b = 0; b < kBlocks; b++) {
+            delete table->blocks[b];
+        }
+        delete table;
+    }
+};
+
+/**
+ * # Per object thread local value
+ * Unlike thread_local variable each ThreadLocal instance has its own set of values, so it could be
+ * a member of a class with many instances. Value for the current thread is created on the first access
+ * and found by the instance id in the table of the thread, see ThreadSlots.
+ *
+ * When thread exits its value is passed to the exit hook (if any) and destroyed. Hook must not create
+ * or destroy ThreadLocal instances. Values of all live threads could be enumerated, for example to
+ * aggregate statistics.
+ *
+ * ThreadLocal must outlive threads that still access it: destructor frees values of all threads
+ * but couldn't stop a thread in the middle of get()
+ */
+template <typename T> class ThreadLocal {
+public:
+    // Called with the value of a thread which is about to exit
+    using ExitHook = std::function<void(T &)>;
+
+    ThreadLocal(ExitHook on_exit = nullptr)
+        : _on_exit(std::move(on_exit)), _id(ThreadSlots::Acquire()), _head(nullptr) {}
+
+    ~ThreadLocal() {
+        {
+            // Exiting threads can't release values while they are taken from cells here
+            std::lock_guard<std::mutex> exit_lock(ThreadSlots::Lock());
+            std::lock_guard<std::mutex> lock(_mutex);
+            while (_head != nullptr) {
+                Entry *next = _head->next;
+                _head->cell.store(nullptr, std::memory_order_relaxed);
+                delete _head;
+                _head = next;
+            }
+        }
+        ThreadSlots::Retire(_id);
+    }
+
+    /**
+     * Value of the current thread, default constructed on the first call
+     */
+    T &get() {
+        ThreadSlots::Cell *cell = ThreadSlots::Find(_id);
+        ThreadSlots::Value *value = cell != nullptr ? cell->load(std::memory_order_relaxed) : nullptr;
+        if (value == nullptr) {
+            return _create()->value;
+        }
+        return static_cast<Entry *>(value)->value;
+    }
+
+    T &operator*() { return get(); }
+    T *operator->() { return &get(); }
+
+    /**
+     * Calls f(T&) for values of all threads. Values could be modified by their owners
+     * concurrently, so T should be safe for that (atomics for example)
+     */
+    template <typename F> void for_each(F f) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Entry *e = _head; e != nullptr; e = e->next) {
+            f(e->value);
+        }
+    }
+
+    /**
+     * Number of threads having value
+     */
+    std::size_t size() {
+        std::size_t result = 0;
+        for_each([&result](T &) { result++; });
+        return result;
+    }
+
+private:
+    ThreadLocal(const ThreadLocal &) = delete;
+    ThreadLocal &operator=(const ThreadLocal &) = delete;
+
+    // Value of one thread linked into the list of all values of the instance
+    struct Entry : ThreadSlots::Value {
+        Entry(ThreadLocal *o, ThreadSlots::Cell &c) : owner(o), cell(c), value(), prev(nullptr), next(nullptr) {}
+
+        // See ThreadSlots::Value
+        void Release() override {
+            owner->_unlink(this);
+            if (owner->_on_exit) {
+                owner->_on_exit(value);
+            }
+            delete this;
+        }
+
+        ThreadLocal *const owner;
+        ThreadSlots::Cell &cell;
+        T value;
+        Entry *prev;
+        Entry *next;
+    };
+
+    // Slow path of get(): allocates value and registers it
+    Entry *_create() {
+        ThreadSlots::Cell &cell = ThreadSlots::Create(_id);
+        Entry *entry = new Entry(this, cell);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            entry->next = _head;
+            if (_head != nullptr) {
+                _head->prev = entry;
+            }
+            _head = entry;
+        }
+        cell.store(entry, std::memory_order_relaxed);
+        return entry;
+    }
+
+    void _unlink(Entry *entry) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (entry->prev != nullptr) {
+            entry->prev->next = entry->next;
+        } else {
+            _head = entry->next;
+        }
+        if (entry->next != nullptr) {
+            entry->next->prev = entry->prev;
+        }
+    }
+
+    const ExitHook _on_exit;
+
+    // Index of the instance in tables of threads
+    const std::size_t _id;
+
+    // Values of all threads, protected by the mutex
+    std::mutex _mutex;
+    Entry *_head;
+};
 
 } // namespace Concurrency
 } // namespace Afina
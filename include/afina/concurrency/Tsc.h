@@ -0,0 +1,94 @@
+#ifndef AFINA_CONCURRENCY_TSC_H
+#define AFINA_CONCURRENCY_TSC_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Cycle counter clock
+ * Reads TSC, which is a couple of dozens cycles against a vDSO call of steady_clock, so timestamps
+ * could be taken at every phase of every request. Modern x86 CPUs have invariant TSC which ticks at
+ * constant rate and is synchronized between cores, its rate is calibrated once against steady_clock.
+ * Other architectures fall back to steady_clock nanoseconds.
+ */
+class Tsc {
+public:
+    static uint64_t Now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    /**
+     * Converts ticks to nanoseconds, first call calibrates the rate for a few milliseconds
+     */
+    static uint64_t ToNanos(uint64_t ticks) { return static_cast<uint64_t>(ticks * NanosPerTick()); }
+
+    static double NanosPerTick();
+};
+
+/**
+ * # Time current thread waits for locks
+ * Traced code enables accounting for the duration of a request, TracedMutex then adds time spent
+ * in lock() to the thread counter. While accounting is off lock() costs one thread local flag check.
+ */
+class LockWait {
+public:
+    // Starts accounting for the current thread
+    static void Begin() {
+        _enabled = true;
+        _ticks = 0;
+    }
+
+    // Stops accounting, returns ticks waited since Begin
+    static uint64_t End() {
+        _enabled = false;
+        return _ticks;
+    }
+
+    static bool Enabled() { return _enabled; }
+    static void Add(uint64_t ticks) { _ticks += ticks; }
+
+private:
+    static thread_local bool _enabled;
+    static thread_local uint64_t _ticks;
+};
+
+/**
+ * # Mutex reporting its wait time to LockWait
+ */
+class TracedMutex {
+public:
+    void lock() {
+        if (!LockWait::Enabled()) {
+            _mutex.lock();
+            return;
+        }
+        uint64_t started = Tsc::Now();
+        _mutex.lock();
+        LockWait::Add(Tsc::Now() - started);
+    }
+
+    bool try_lock() { return _mutex.try_lock(); }
+    void unlock() { _mutex.unlock(); }
+
+private:
+    std::mutex _mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TSC_H
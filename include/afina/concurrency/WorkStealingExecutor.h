@@ -0,0 +1,115 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
+#define AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Task.h>
+
+namespace Afina {
+namespace Concurrency {
+
+// Forward declaration, see TaskPool.h
+struct TaskNode;
+
+/**
+ * # Work stealing thread pool
+ * Alternative to Executor with the same Execute API. Each worker owns a Chase-Lev deque: tasks
+ * submitted from a pool thread go to its own deque, tasks from outside go to the shared injection
+ * queue. Idle worker checks own deque, then injection queue, then tries to steal from random
+ * victims and at last parks on a futex until somebody submits more work.
+ *
+ * Pool has fixed number of threads, there is no queue limit.
+ */
+class WorkStealingExecutor {
+public:
+    WorkStealingExecutor(std::string name, std::size_t threads);
+    ~WorkStealingExecutor();
+
+    /**
+     * Spawns worker threads and allows tasks to be added
+     */
+    void Start();
+
+    /**
+     * Signal thread pool to stop, it will stop accepting new jobs, all queued jobs will be complete.
+     *
+     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped
+     */
+    void Stop(bool await = false);
+
+    /**
+     * Add function to be executed on the threadpool. Method returns true in case if task has been placed
+     * onto execution queue, i.e scheduled for execution and false otherwise.
+     */
+    template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
+        if (_state.load(std::memory_order_acquire) != State::kRun) {
+            return false;
+        }
+        return _push(Task(std::bind(std::forward<F>(func), std::forward<Types>(args)...)));
+    }
+
+private:
+    enum class State { kReady, kRun, kStopping, kStopped };
+
+    // Per thread state, see WorkStealingExecutor.cpp
+    class Worker;
+
+    WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+    WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+    /**
+     * Places task onto current worker deque or into injection queue and wakes up one parked
+     * worker if any
+     */
+    bool _push(Task &&task);
+
+    /**
+     * Main loop of the worker thread
+     */
+    void _run(Worker *self);
+
+    /**
+     * Finds next task for the worker: own deque, injection queue, victims
+     */
+    TaskNode *_next(Worker *self);
+
+    /**
+     * True if there is any task visible in the pool
+     */
+    bool _has_work() const;
+
+    // Worker the current thread belongs to, nullptr for threads outside of any pool
+    static thread_local Worker *_current_worker;
+
+    // Pool name, used for diagnostics only
+    const std::string _name;
+
+    std::atomic<State> _state;
+
+    // Workers, each owns a deque
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+
+    // Tasks submitted from outside of the pool, intrusive list of pooled nodes
+    std::mutex _inject_mutex;
+    TaskNode *_inject_head;
+    TaskNode *_inject_tail;
+    std::atomic<std::size_t> _inject_size;
+
+    // Futex word, gets incremented each time parked workers must re-check queues
+    std::atomic<int> _epoch;
+
+    // Number of workers that are about to park or already parked
+    std::atomic<int> _sleepers;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
@@ -0,0 +1,90 @@
+#ifndef AFINA_EXECUTE_BATCH_H
+#define AFINA_EXECUTE_BATCH_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/SlowLog.h>
+
+namespace Afina {
+
+class Storage;
+
+namespace Execute {
+
+class Get;
+
+/**
+ * # Pipelined commands executed together
+ * Network implementation collects all commands complete in the input at hand and executes them at
+ * once. Keys of consecutive Get commands are looked up with a single Storage::GetMany, so sharded
+ * storage takes lock of every shard once per run of gets rather than once per key. Other commands
+ * are executed one by one in order, so every command still sees effects of the previous ones.
+ *
+ * Responses are appended to one buffer. Slots keep their capacity between batches, steady state
+ * pipelining doesn't go to the heap for them.
+ */
+class Batch {
+public:
+    // Largest argument buffer slot keeps after its command is executed
+    static constexpr std::size_t kKeepArgument = 4096;
+
+    // Called once response of the command is in the buffer, with trace of its request and size
+    using Done = std::function<void(RequestTrace &trace, std::size_t size)>;
+
+    Batch() : _size(0) {}
+
+    bool Empty() const { return _size == 0; }
+
+    std::size_t Size() const { return _size; }
+
+    /**
+     * Adds parsed command. Argument and trace of the request are taken over, both are left empty
+     *
+     * @param command to execute
+     * @param name protocol name of the command, for metrics
+     * @param args argument of the command
+     * @param trace of the request
+     */
+    void Add(std::unique_ptr<Command> command, const std::string &name, std::string &args, RequestTrace &trace);
+
+    /**
+     * Executes all commands added so far and appends their responses, each followed by "\r\n". Command
+     * which throws gets "SERVER_ERROR <what>" as its response, the rest of the batch goes on
+     *
+     * @param storage to execute commands on
+     * @param out buffer to append responses to
+     * @param done called for every command in order
+     */
+    void Execute(Storage &storage, std::string &out, const Done &done);
+
+private:
+    struct Item {
+        std::unique_ptr<Command> command;
+        // Same command if it is a Get, nullptr otherwise
+        Get *get;
+        std::string name;
+        std::string args;
+        RequestTrace trace;
+    };
+
+    // Executes gets in items [begin, end) with one lookup
+    void _execute_gets(Storage &storage, std::size_t begin, std::size_t end, std::string &out, const Done &done);
+
+    std::vector<Item> _items;
+    std::size_t _size;
+
+    // Lookup scratch space of _execute_gets
+    std::vector<const std::string *> _keys;
+    std::vector<std::string> _values;
+    std::vector<bool> _found;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_BATCH_H
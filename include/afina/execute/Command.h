@@ -19,6 +19,12 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Key command is going to access, used to route it to the owner of the data. nullptr if command
+     * doesn't touch storage by key
+     */
+    virtual const std::string *RoutingKey() const { return nullptr; }
 };
 
 } // namespace Execute
@@ -41,6 +41,22 @@ public:
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    /**
+     * Appends keys to look up with Storage::GetMany, so that keys of several commands could be
+     * looked up at once
+     */
+    void Prepare(std::vector<const std::string *> &keys) const;
+
+    /**
+     * Appends items found to the response, without the final END. Results for keys of the command
+     * start at the given position of the lookup output
+     */
+    void Respond(const std::vector<std::string> &values, const std::vector<bool> &found, std::size_t first,
+                 std::string &out) const;
+
+    // Multi key request is routed by its first key
+    const std::string *RoutingKey() const override { return _keys.empty() ? nullptr : &_keys.front(); }
+
 private:
     std::vector<std::string> _keys;
 };
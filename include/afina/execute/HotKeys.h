@@ -0,0 +1,129 @@
+#ifndef AFINA_EXECUTE_HOT_KEYS_H
+#define AFINA_EXECUTE_HOT_KEYS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Space-Saving heavy hitters sketch
+ * Keeps at most capacity counters. Unknown key takes over the counter with the smallest count and
+ * inherits it as the error, so any key seen more than total/capacity times is guaranteed to be in
+ * the sketch and its count is overestimated by at most the error.
+ *
+ * Capacity is small, so the smallest counter is found by a linear scan.
+ */
+class TopK {
+public:
+    struct Entry {
+        std::string key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    explicit TopK(std::size_t capacity = 64) : _capacity(capacity), _total(0) {}
+
+    /**
+     * Accounts weight occurrences of the key
+     */
+    void Add(const std::string &key, uint64_t weight = 1);
+
+    /**
+     * Adds counters of the other sketch, as if its keys were added here
+     */
+    void Merge(const TopK &other);
+
+    /**
+     * Up to n entries with the largest counts, largest first
+     */
+    std::vector<Entry> Top(std::size_t n) const;
+
+    // Sum of all weights added
+    uint64_t Total() const { return _total; }
+
+    std::size_t Capacity() const { return _capacity; }
+
+    void Clear();
+
+private:
+    // Replaces key with the smallest count, or adds a new counter while there is room
+    void _take(const std::string &key, uint64_t weight, uint64_t error);
+
+    std::size_t _capacity;
+    uint64_t _total;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, std::size_t> _index;
+};
+
+/**
+ * # Hot keys tracker
+ * Commands report every key they touch, one of sample_every keys is added to the sketch of the
+ * current thread. Sketches are merged only when "stats hotkeys" asks for them, sketch of the exiting
+ * thread is merged into the retired one. Until enabled Touch costs one relaxed load.
+ */
+class HotKeys {
+public:
+    static HotKeys &Default();
+
+    /**
+     * @param capacity counters in every sketch
+     * @param sample_every track one of that many accesses, 0 turns tracking off
+     */
+    void Configure(std::size_t capacity, uint32_t sample_every);
+
+    bool Enabled() const { return _sample_every.load(std::memory_order_relaxed) != 0; }
+
+    void Touch(const std::string &key) {
+        const uint32_t every = _sample_every.load(std::memory_order_relaxed);
+        if (every != 0) {
+            _touch(key, every);
+        }
+    }
+
+    /**
+     * Top keys over all threads with estimated number of accesses and share of all of them
+     */
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats, std::size_t n = 10);
+
+    /**
+     * Forgets everything seen so far
+     */
+    void Reset();
+
+private:
+    HotKeys();
+
+    // Sketch of one thread, lock is taken by the owner and the reader only. Sketch is sized on the
+    // first sample, capacity could be configured after thread got its value
+    struct Local {
+        std::mutex mutex;
+        TopK sketch{0};
+        uint32_t skipped = 0;
+    };
+
+    void _touch(const std::string &key, uint32_t every);
+
+    std::atomic<uint32_t> _sample_every;
+    std::atomic<std::size_t> _capacity;
+
+    // Sketches of exited threads
+    std::mutex _mutex;
+    TopK _retired;
+
+    Concurrency::ThreadLocal<Local> _locals;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_HOT_KEYS_H
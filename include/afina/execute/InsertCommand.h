@@ -22,6 +22,8 @@ public:
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    const std::string *RoutingKey() const override { return &_key; }
+
 protected:
     const std::string _key;
     const uint32_t _flags;
@@ -0,0 +1,105 @@
+#ifndef AFINA_EXECUTE_METRICS_H
+#define AFINA_EXECUTE_METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/Histogram.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Server wide request metrics
+ * Counters behind memcached "stats" and latency histograms of each command behind "stats latency".
+ * Updated by network implementations and commands from any thread, every update touches only per
+ * CPU cells, so instrumentation doesn't add shared cache lines to the hot path.
+ */
+class Metrics {
+public:
+    // Commands having own latency histogram, the last one collects everything else
+    static constexpr std::size_t kCommands = 6;
+
+    /**
+     * Instance shared by the whole process
+     */
+    static Metrics &Default();
+
+    /**
+     * Histogram index of the command with the given protocol name
+     */
+    static std::size_t CommandIndex(const std::string &name);
+    static const char *CommandName(std::size_t index);
+
+    void ConnectionOpened() {
+        _total_connections.Add();
+        _curr_connections.Add();
+    }
+    void ConnectionClosed() { _curr_connections.Add(-1); }
+
+    void GetHit() { _get_hits.Add(); }
+    void GetMiss() { _get_misses.Add(); }
+
+    /**
+     * Accounts one command execution which took given number of nanoseconds
+     */
+    void CommandDone(std::size_t index, uint64_t ns) { _latency[index % kCommands].Record(ns); }
+
+    /**
+     * General counters in memcached order: pid, uptime, time, connections, cmd_*, get_*
+     */
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats);
+
+    /**
+     * Count and percentiles in microseconds of every executed command
+     */
+    void Latency(std::vector<std::pair<std::string, std::string>> &stats);
+
+    /**
+     * Counters and latency histograms in Prometheus text format, appended to out
+     */
+    void Prometheus(std::string &out);
+
+private:
+    Metrics();
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    const std::chrono::steady_clock::time_point _started;
+
+    Concurrency::CoreCounter _curr_connections;
+    Concurrency::CoreCounter _total_connections;
+    Concurrency::CoreCounter _get_hits;
+    Concurrency::CoreCounter _get_misses;
+
+    Concurrency::Histogram _latency[kCommands];
+};
+
+/**
+ * # Command execution timer
+ * Records time from construction to destruction into the latency histogram of the command
+ */
+class CommandTimer {
+public:
+    explicit CommandTimer(const std::string &name)
+        : _index(Metrics::CommandIndex(name)), _started(std::chrono::steady_clock::now()) {}
+
+    ~CommandTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _started);
+        Metrics::Default().CommandDone(_index, ns.count());
+    }
+
+private:
+    const std::size_t _index;
+    const std::chrono::steady_clock::time_point _started;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_METRICS_H
@@ -18,6 +18,7 @@ namespace Execute {
  * - "STORED", to indicate success.
  * - "NOT_STORED" to indicate the data was not stored, but not because of an
  * error. This normally means that the condition for the command wasn't met.
+ * - "SERVER_ERROR ..." if storage refused the value: it doesn't fit or couldn't be made durable.
  */
 class Replace : public InsertCommand {
 public:
@@ -0,0 +1,188 @@
+#ifndef AFINA_EXECUTE_SLOW_LOG_H
+#define AFINA_EXECUTE_SLOW_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <sys/types.h>
+
+#include <afina/concurrency/Tsc.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Execute {
+
+class Command;
+
+/**
+ * # Phases of one request
+ * Network implementation opens trace when the first byte of a request gets parsed and closes it once
+ * response is written. Sampled traces collect TSC ticks spent in every phase, not sampled ones cost
+ * a flag check per phase. Time not covered by phases is waiting: for the rest of the input, in
+ * the output queue or for the worker.
+ */
+class RequestTrace {
+public:
+    enum class Phase { Read, Parse, Execute, Lock, Write };
+    static constexpr std::size_t kPhases = 5;
+
+    RequestTrace() : _last_read(0) { Reset(); }
+
+    /**
+     * read(2) which remembers its duration: request starting in these bytes accounts it as Read
+     */
+    ssize_t Read(int fd, void *buf, std::size_t size);
+
+    /**
+     * Opens trace of the next request unless it is open already, slowlog decides whether to sample it
+     */
+    void Begin();
+
+    bool Active() const { return _active; }
+
+    void Add(Phase phase, uint64_t ticks) { _ticks[static_cast<std::size_t>(phase)] += ticks; }
+
+    /**
+     * Remembers what request was, called once it is executed
+     */
+    void Describe(const std::string &name, const Command &command, std::size_t arg_size, std::size_t out_size);
+
+    /**
+     * Closes trace, reports it to the slowlog if it took too long
+     */
+    void End();
+
+    /**
+     * Drops trace without reporting, for example when connection is gone in the middle of a request
+     */
+    void Reset();
+
+    // Accessors for the slowlog
+    uint64_t Ticks(Phase phase) const { return _ticks[static_cast<std::size_t>(phase)]; }
+    uint64_t Started() const { return _started; }
+    const std::string &Name() const { return _name; }
+    const std::string &Key() const { return _key; }
+    std::size_t ArgSize() const { return _arg_size; }
+    std::size_t OutSize() const { return _out_size; }
+
+private:
+    bool _open;
+    bool _active;
+
+    // Duration of the last read, becomes Read phase of the request started in its data
+    uint64_t _last_read;
+
+    uint64_t _started;
+    uint64_t _ticks[kPhases];
+
+    std::string _name;
+    std::string _key;
+    std::size_t _arg_size;
+    std::size_t _out_size;
+};
+
+/**
+ * # Scope of one request phase
+ * Adds time from construction to destruction to the trace if it is sampled. Execute phase also
+ * collects time spent waiting for storage locks, see Concurrency::LockWait
+ */
+class TracePhase {
+public:
+    TracePhase(RequestTrace &trace, RequestTrace::Phase phase)
+        : _trace(trace), _phase(phase), _started(trace.Active() ? Concurrency::Tsc::Now() : 0) {
+        if (_started != 0 && _phase == RequestTrace::Phase::Execute) {
+            Concurrency::LockWait::Begin();
+        }
+    }
+
+    ~TracePhase() {
+        if (_started == 0) {
+            return;
+        }
+        _trace.Add(_phase, Concurrency::Tsc::Now() - _started);
+        if (_phase == RequestTrace::Phase::Execute) {
+            _trace.Add(RequestTrace::Phase::Lock, Concurrency::LockWait::End());
+        }
+    }
+
+private:
+    RequestTrace &_trace;
+    const RequestTrace::Phase _phase;
+    const uint64_t _started;
+};
+
+/**
+ * # Traces of requests waiting for their responses to be written
+ * Nonblocking connections queue responses and write them later, possibly several at once or in
+ * parts: bytes of every queued response are accounted here and traces are closed once write gets
+ * past the end of their responses
+ */
+class PendingTraces {
+public:
+    PendingTraces() : _queued(0), _written(0) {}
+
+    /**
+     * Response of the given size was queued for the request, trace is moved here if sampled and
+     * reset anyway
+     */
+    void Queued(RequestTrace &trace, std::size_t bytes);
+
+    /**
+     * Write call which took given ticks sent number of bytes
+     */
+    void Written(std::size_t bytes, uint64_t ticks);
+
+private:
+    uint64_t _queued;
+    uint64_t _written;
+    std::deque<std::pair<uint64_t, RequestTrace>> _traces;
+};
+
+/**
+ * # Log of slow requests
+ * Requests taking longer than threshold are written to the "slowlog" logger with command, key,
+ * sizes and time spent in every phase. Only one of every N requests is traced to keep overhead low.
+ */
+class SlowLog {
+public:
+    static SlowLog &Default();
+
+    /**
+     * @param logger where to write slow requests
+     * @param threshold_us requests longer than that are logged, 0 turns tracing off
+     * @param sample_every trace one of that many requests
+     */
+    void Configure(std::shared_ptr<spdlog::logger> logger, uint64_t threshold_us, uint32_t sample_every);
+
+    bool Enabled() const { return _threshold_ns.load(std::memory_order_relaxed) != 0; }
+
+    /**
+     * Whether the next request of the current thread should be traced
+     */
+    bool Sample();
+
+    /**
+     * Logs the trace if it is slow
+     */
+    void Report(const RequestTrace &trace);
+
+private:
+    SlowLog() : _threshold_ns(0), _sample_every(1) {}
+
+    std::shared_ptr<spdlog::logger> _logger;
+    std::atomic<uint64_t> _threshold_ns;
+    std::atomic<uint32_t> _sample_every;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_SLOW_LOG_H
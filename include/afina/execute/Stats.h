@@ -2,17 +2,30 @@
 #define AFINA_EXECUTE_STATS_H
 
 #include <string>
+#include <vector>
 
 #include "Command.h"
 
 namespace Afina {
 namespace Execute {
 
+/**
+ * # Server statistics
+ * Without arguments reports general counters (see Metrics) followed by the storage ones, with
+ * "latency" argument - percentiles of command execution time, with "hotkeys" - most accessed keys
+ * (see HotKeys), "hotkeys reset" forgets them. Other groups get "CLIENT_ERROR unknown stats group"
+ */
 class Stats : public Command {
 public:
-    Stats() {}
+    Stats(const std::vector<std::string> &args = {}) : _args(args) {}
     ~Stats() {}
+
+    inline const std::vector<std::string> &args() const { return _args; }
+
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+private:
+    std::vector<std::string> _args;
 };
 
 } // namespace Execute
@@ -0,0 +1,125 @@
+#ifndef AFINA_NETWORK_LIMITS_H
+#define AFINA_NETWORK_LIMITS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Resource limits of client connections
+ * Zero turns the limit off
+ */
+struct Limits {
+    // Largest data block of a storage command
+    std::size_t max_item = 1024 * 1024;
+
+    // Longest command line, name and keys included
+    std::size_t max_input = 64 * 1024;
+
+    // Responses queued for one connection which stop it from reading requests until they are sent
+    std::size_t max_output = 256 * 1024;
+
+    // Buffers of all connections together
+    std::size_t max_memory = 256 * 1024 * 1024;
+};
+
+/**
+ * # Client went over one of the limits
+ * Message is ready to be sent back as SERVER_ERROR, connection is closed afterwards
+ */
+class LimitExceeded : public std::runtime_error {
+public:
+    explicit LimitExceeded(const std::string &what) : std::runtime_error(what) {}
+};
+
+/**
+ * Best effort SERVER_ERROR reply to the client which went over a limit, connection is about to be
+ * closed so nothing is done if socket isn't ready to take it
+ */
+void ReplyLimitExceeded(int socket, const LimitExceeded &ex);
+
+/**
+ * # Memory of client connections
+ * One per server: connections take memory for their buffers from it and give it back once closed.
+ * Memory is taken in kStep units, so that requests of ordinary size never touch the shared counter.
+ */
+class ConnectionMemory {
+public:
+    static constexpr std::size_t kStep = 64 * 1024;
+
+    explicit ConnectionMemory(const Limits &limits = Limits()) : _limits(limits), _used(0), _rejected(0) {}
+
+    const Limits &limits() const { return _limits; }
+
+    // Memory taken by all connections
+    std::size_t Used() const { return _used.load(std::memory_order_relaxed); }
+
+    // Connections closed because there was no memory left for them
+    uint64_t Rejected() const { return _rejected.load(std::memory_order_relaxed); }
+
+private:
+    friend class ConnectionGuard;
+
+    // Takes memory, false if it would exceed the limit
+    bool _reserve(std::size_t size);
+
+    void _release(std::size_t size) { _used.fetch_sub(size, std::memory_order_relaxed); }
+
+    const Limits _limits;
+    std::atomic<std::size_t> _used;
+    std::atomic<uint64_t> _rejected;
+};
+
+/**
+ * # Limits of one connection
+ * Every network implementation calls it at the same points: Line after each parser step, Item once
+ * storage command is parsed and Use whenever its argument or queued output changes size. Checks
+ * which fail throw LimitExceeded.
+ */
+class ConnectionGuard {
+public:
+    /**
+     * Takes the first step of memory for the input buffer and parser state
+     */
+    explicit ConnectionGuard(ConnectionMemory &memory);
+    ~ConnectionGuard() { _memory._release(_reserved); }
+
+    /**
+     * Checks length of the command line parsed so far
+     */
+    void Line(std::size_t size) const;
+
+    /**
+     * Checks size of the data block of a storage command
+     */
+    void Item(std::size_t size) const;
+
+    /**
+     * Accounts memory held by the connection buffers on top of the first step
+     */
+    void Use(std::size_t size);
+
+    /**
+     * Whether queued output is large enough to stop reading requests
+     */
+    bool Paused(std::size_t output) const {
+        return _memory._limits.max_output != 0 && output >= _memory._limits.max_output;
+    }
+
+private:
+    ConnectionGuard(const ConnectionGuard &) = delete;
+    ConnectionGuard &operator=(const ConnectionGuard &) = delete;
+
+    ConnectionMemory &_memory;
+    std::size_t _reserved;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_LIMITS_H
@@ -0,0 +1,80 @@
+#ifndef AFINA_NETWORK_OUTPUT_BUFFER_H
+#define AFINA_NETWORK_OUTPUT_BUFFER_H
+
+#include <cstddef>
+#include <string>
+
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Chain of responses waiting to be sent
+ * Data is kept in fixed size chunks from a shared pool: appending never moves bytes already
+ * buffered, sent chunks go back to the pool right away and writev gets iovecs pointing straight
+ * into the chunks, so steady state output allocates nothing. Not thread safe.
+ */
+class OutputBuffer {
+public:
+    // Size of one chunk including its header
+    static constexpr std::size_t kChunkSize = 4096;
+
+    OutputBuffer() : _head(nullptr), _tail(nullptr), _size(0) {}
+    ~OutputBuffer() { Clear(); }
+
+    /**
+     * Copies data to the end of the buffer
+     */
+    void Append(const char *data, std::size_t size);
+    void Append(const std::string &data) { Append(data.data(), data.size()); }
+
+    /**
+     * Points iovecs at data not sent yet, from the oldest one
+     *
+     * @param iov iovecs to fill
+     * @param max number of iovecs available
+     * @return number of iovecs filled
+     */
+    int Prepare(struct iovec *iov, int max) const;
+
+    /**
+     * Drops bytes sent from the front of the buffer
+     */
+    void Consume(std::size_t size);
+
+    /**
+     * Drops all data and returns chunks to the pool
+     */
+    void Clear();
+
+    // Bytes not sent yet
+    std::size_t Size() const { return _size; }
+    bool Empty() const { return _size == 0; }
+
+private:
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    struct Chunk {
+        Chunk *next;
+        // Unsent data is in [begin, end) of data
+        std::size_t begin;
+        std::size_t end;
+        char data[1];
+    };
+
+    static constexpr std::size_t kCapacity = kChunkSize - offsetof(Chunk, data);
+
+    // Takes chunk from the pool and links it at the tail
+    void _grow();
+
+    Chunk *_head;
+    Chunk *_tail;
+    std::size_t _size;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_OUTPUT_BUFFER_H
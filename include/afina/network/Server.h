@@ -2,8 +2,12 @@
 #define AFINA_NETWORK_SERVER_H
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <afina/network/Limits.h>
+
 namespace Afina {
 class Storage;
 namespace Logging {
@@ -18,9 +22,14 @@ namespace Network {
 class Server {
 public:
     Server(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-        : pStorage(ps), pLogging(pl) {}
+        : pStorage(ps), pLogging(pl), pMemory(std::make_shared<ConnectionMemory>()) {}
     virtual ~Server() {}
 
+    /**
+     * Sets limits on resources taken by client connections, must be called before Start
+     */
+    void SetLimits(const Limits &limits) { pMemory = std::make_shared<ConnectionMemory>(limits); }
+
     /**
      * Starts network service. After method returns process should
      * listen on the given interface/port pair to process  incomming
@@ -44,6 +53,16 @@ public:
      */
     virtual void Join() = 0;
 
+    /**
+     * Appends counters of the network implementation as name/value pairs, exported by the admin server
+     *
+     * @param stats output parameter to append statistics to
+     */
+    virtual void Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+        stats.emplace_back("connection_memory_bytes", std::to_string(pMemory->Used()));
+        stats.emplace_back("connections_rejected", std::to_string(pMemory->Rejected()));
+    }
+
 protected:
     /**
      * Instance of backing storeage on which current server should execute
@@ -55,6 +74,11 @@ protected:
      * Logging service to be used in order to report application progress
      */
     std::shared_ptr<Afina::Logging::Service> pLogging;
+
+    /**
+     * Limits and memory shared by all client connections
+     */
+    std::shared_ptr<ConnectionMemory> pMemory;
 };
 
 } // namespace Network
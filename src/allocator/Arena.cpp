@@ -0,0 +1,69 @@
+#include <afina/allocator/Arena.h>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr std::size_t Arena::kSlabSize;
+
+Arena::Arena(std::size_t chunk_size, const PagePolicy &policy)
+    : _chunk_size((chunk_size + kSlabSize - 1) / kSlabSize * kSlabSize), _policy(policy), _next(nullptr),
+      _end(nullptr) {}
+
+Arena::~Arena() {}
+
+// See Arena.h
+void *Arena::Map() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_next == _end) {
+        _grow();
+    }
+
+    void *slab = _next;
+    _next += kSlabSize;
+    return slab;
+}
+
+// See Arena.h
+std::size_t Arena::Mapped() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t result = 0;
+    for (auto &chunk : _chunks) {
+        result += chunk.size();
+    }
+    return result;
+}
+
+// See Arena.h
+std::size_t Arena::Mapped(PageKind kind) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t result = 0;
+    for (auto &chunk : _chunks) {
+        if (chunk.kind() == kind) {
+            result += chunk.size();
+        }
+    }
+    return result;
+}
+
+// See Arena.h
+PageKind Arena::SetPolicy(const PagePolicy &policy) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _policy = policy;
+    _grow();
+    return _chunks.back().kind();
+}
+
+void Arena::_grow() {
+    _chunks.emplace_back(_chunk_size, kSlabSize, _policy);
+    _next = _chunks.back().data();
+    _end = _next + _chunk_size;
+}
+
+// See Arena.h
+Arena &Arena::Default() {
+    static Arena *instance = new Arena;
+    return *instance;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,76 @@
+#include <afina/allocator/MemoryResource.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr std::size_t MemoryResource::kMaxAlign;
+
+namespace {
+
+class NewDelete : public MemoryResource {
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (alignment <= kMaxAlign) {
+            return ::operator new(bytes);
+        }
+
+        void *p = nullptr;
+        if (posix_memalign(&p, alignment, bytes) != 0) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        if (alignment <= kMaxAlign) {
+            ::operator delete(p);
+        } else {
+            std::free(p);
+        }
+    }
+
+    bool do_is_equal(const MemoryResource &other) const noexcept override {
+        return dynamic_cast<const NewDelete *>(&other) != nullptr;
+    }
+
+    // Size of glibc malloc chunk: 8 bytes header, 16 bytes granularity, 32 bytes at least
+    std::size_t do_footprint(std::size_t bytes, std::size_t alignment) const override {
+        std::size_t chunk = (bytes + sizeof(std::size_t) + 15) & ~std::size_t(15);
+        return (chunk < 32 ? 32 : chunk) + (alignment > kMaxAlign ? alignment : 0);
+    }
+};
+
+} // namespace
+
+// See MemoryResource.h
+MemoryResource *NewDeleteResource() {
+    static NewDelete *instance = new NewDelete;
+    return instance;
+}
+
+void *CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::size_t taken = _upstream->footprint(bytes, alignment);
+    std::size_t was = _allocated.fetch_add(taken, std::memory_order_relaxed);
+    if (_limit != 0 && was + taken > _limit) {
+        _allocated.fetch_sub(taken, std::memory_order_relaxed);
+        throw std::bad_alloc();
+    }
+
+    try {
+        return _upstream->allocate(bytes, alignment);
+    } catch (...) {
+        _allocated.fetch_sub(taken, std::memory_order_relaxed);
+        throw;
+    }
+}
+
+void CountingResource::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    _upstream->deallocate(p, bytes, alignment);
+    _allocated.fetch_sub(_upstream->footprint(bytes, alignment), std::memory_order_relaxed);
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,131 @@
+#include <afina/allocator/Mempool.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr std::size_t Mempool::kBatch;
+
+static std::size_t round_object(std::size_t size) {
+    const std::size_t align = alignof(std::max_align_t);
+    if (size < sizeof(void *)) {
+        size = sizeof(void *);
+    }
+    return (size + align - 1) / align * align;
+}
+
+Mempool::Mempool(std::size_t object_size, SlabCache &slabs)
+    : _object_size(round_object(object_size)), _batch(std::min(kBatch, Arena::kSlabSize / _object_size)),
+      _slabs(slabs), _free(0), _caches([this](Cache &cache) {
+          while (cache.size >= _batch) {
+              _flush(cache);
+          }
+          // Pools live forever and threads come and go with connections, nothing may be stranded
+          if (cache.head != nullptr) {
+              std::lock_guard<std::mutex> lock(_mutex);
+              _chains.push_back(Chain{cache.head, cache.size});
+              _free += cache.size;
+              cache.head = nullptr;
+              cache.size = 0;
+          }
+      }) {
+    if (_batch == 0) {
+        throw std::runtime_error("Object is too large for mempool");
+    }
+}
+
+Mempool::~Mempool() {
+    for (void *slab : _owned) {
+        _slabs.Put(slab);
+    }
+}
+
+// See Mempool.h
+void *Mempool::Alloc() {
+    Cache &cache = _caches.get();
+    if (cache.head == nullptr) {
+        _refill(cache);
+    }
+
+    FreeObject *object = cache.head;
+    cache.head = object->next;
+    cache.size--;
+    return object;
+}
+
+// See Mempool.h
+void Mempool::Free(void *ptr) {
+    Cache &cache = _caches.get();
+    FreeObject *object = static_cast<FreeObject *>(ptr);
+    object->next = cache.head;
+    cache.head = object;
+    cache.size++;
+
+    if (cache.size >= 2 * _batch) {
+        _flush(cache);
+    }
+}
+
+// See Mempool.h
+std::size_t Mempool::Slabs() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _owned.size();
+}
+
+void Mempool::_flush(Cache &cache) {
+    FreeObject *chain = cache.head;
+    FreeObject *last = cache.head;
+    for (std::size_t i = 1; i < _batch; i++) {
+        last = last->next;
+    }
+    cache.head = last->next;
+    last->next = nullptr;
+    cache.size -= _batch;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _chains.push_back(Chain{chain, _batch});
+    _free += _batch;
+}
+
+// See Mempool.h
+void Mempool::Reserve(std::size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (_free < count) {
+        _carve();
+    }
+}
+
+void Mempool::_refill(Cache &cache) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_chains.empty()) {
+        _carve();
+    }
+
+    cache.head = _chains.back().head;
+    cache.size = _chains.back().size;
+    _free -= cache.size;
+    _chains.pop_back();
+}
+
+void Mempool::_carve() {
+    char *slab = static_cast<char *>(_slabs.Get());
+    _owned.push_back(slab);
+
+    std::size_t count = Arena::kSlabSize / _object_size / _batch * _batch;
+    for (std::size_t i = 0; i < count; i += _batch) {
+        for (std::size_t j = 0; j + 1 < _batch; j++) {
+            reinterpret_cast<FreeObject *>(slab + (i + j) * _object_size)->next =
+                reinterpret_cast<FreeObject *>(slab + (i + j + 1) * _object_size);
+        }
+        reinterpret_cast<FreeObject *>(slab + (i + _batch - 1) * _object_size)->next = nullptr;
+        _chains.push_back(Chain{reinterpret_cast<FreeObject *>(slab + i * _object_size), _batch});
+    }
+    _free += count;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,167 @@
+#include <afina/allocator/Pages.h>
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+namespace {
+
+// Whether madvise(MADV_HUGEPAGE) has any effect: THP must not be disabled system wide
+bool thp_enabled() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode;
+    if (!std::getline(file, mode)) {
+        return false;
+    }
+    return mode.find("[never]") == std::string::npos;
+}
+
+// Touches every page so that it gets allocated now rather than on the first access
+void prefault(char *addr, std::size_t len) {
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    for (std::size_t i = 0; i < len; i += page) {
+        *static_cast<volatile char *>(addr + i) = 0;
+    }
+}
+
+// From linux/mempolicy.h, libnuma isn't required for a single syscall
+const int kMpolPreferred = 1;
+
+// Makes pages of the range come from the given node, must be done before they are touched
+void bind_node(void *addr, std::size_t len, int node) {
+    unsigned long mask[16] = {0};
+    const unsigned long bits = 8 * sizeof(unsigned long);
+    if (node < 0 || node >= int(bits * 16)) {
+        return;
+    }
+    mask[node / bits] |= 1ul << (node % bits);
+    // Best effort: without NUMA support in kernel memory just comes from wherever it is
+    syscall(SYS_mbind, addr, len, kMpolPreferred, mask, bits * 16, 0);
+}
+
+// Maps len bytes with explicit huge pages, nullptr if pool has no free ones
+void *map_huge(std::size_t len, const PagePolicy &policy) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+    void *addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    bind_node(addr, len, policy.node);
+    if (policy.populate) {
+        prefault(static_cast<char *>(addr), len);
+    }
+    return addr;
+}
+
+} // namespace
+
+Mapping::Mapping(std::size_t len, std::size_t align, const PagePolicy &policy)
+    : _addr(nullptr), _len(len), _kind(PageKind::Normal) {
+    if (policy.kind == PageKind::Huge && kHugePageSize % align == 0) {
+        // Kernel aligns hugetlb mappings to the huge page size, length must be multiple of it
+        std::size_t huge_len = (len + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        _addr = map_huge(huge_len, policy);
+        if (_addr != nullptr) {
+            _len = huge_len;
+            _kind = PageKind::Huge;
+            return;
+        }
+    }
+
+    // Huge pages could only back aligned ranges, so align transparent mapping to them
+    bool transparent = policy.kind != PageKind::Normal && thp_enabled();
+    if (transparent && align < kHugePageSize) {
+        align = kHugePageSize;
+    }
+
+    // Over-map to be able to align start, then cut off the excess
+    std::size_t total = len + align;
+    bool bind = policy.node >= 0;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | (policy.populate && !transparent && !bind ? MAP_POPULATE : 0);
+    void *raw = mmap(nullptr, total, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw AllocError(AllocErrorType::NoMemory, "Failed to map " + std::to_string(len) + " bytes");
+    }
+
+    uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (begin + align - 1) & ~uintptr_t(align - 1);
+    if (aligned != begin) {
+        munmap(raw, aligned - begin);
+    }
+    if (aligned + len != begin + total) {
+        munmap(reinterpret_cast<void *>(aligned + len), begin + total - aligned - len);
+    }
+    _addr = reinterpret_cast<void *>(aligned);
+
+    if (bind) {
+        bind_node(_addr, len, policy.node);
+    }
+    if (transparent && madvise(_addr, len, MADV_HUGEPAGE) == 0) {
+        _kind = PageKind::Transparent;
+    }
+    if (policy.populate && (transparent || bind)) {
+        // Populated after binding and advice so that faults are served by the right pages
+        prefault(data(), len);
+    }
+}
+
+Mapping::~Mapping() {
+    if (_addr != nullptr) {
+        munmap(_addr, _len);
+    }
+}
+
+Mapping::Mapping(Mapping &&other) : _addr(other._addr), _len(other._len), _kind(other._kind) {
+    other._addr = nullptr;
+    other._len = 0;
+}
+
+Mapping &Mapping::operator=(Mapping &&other) {
+    if (this != &other) {
+        if (_addr != nullptr) {
+            munmap(_addr, _len);
+        }
+        _addr = other._addr;
+        _len = other._len;
+        _kind = other._kind;
+        other._addr = nullptr;
+        other._len = 0;
+    }
+    return *this;
+}
+
+// See Pages.h
+PageKind ParsePageKind(const std::string &name) {
+    if (name == "off") {
+        return PageKind::Normal;
+    } else if (name == "thp") {
+        return PageKind::Transparent;
+    } else if (name == "on") {
+        return PageKind::Huge;
+    }
+    throw std::runtime_error("Unknown huge pages mode: " + name);
+}
+
+// See Pages.h
+const char *PageKindName(PageKind kind) {
+    switch (kind) {
+    case PageKind::Transparent:
+        return "transparent huge pages";
+    case PageKind::Huge:
+        return "huge pages";
+    default:
+        return "normal pages";
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
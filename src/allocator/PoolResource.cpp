@@ -0,0 +1,77 @@
+#include <afina/allocator/PoolResource.h>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr std::size_t PoolResource::kMaxPooled;
+
+// Size classes: step of 16 bytes up to 128, then four classes per power of two
+static const std::size_t kClasses[] = {16,   32,   48,   64,   80,   96,   112,  128,  160,  192,  224,
+                                       256,  320,  384,  448,  512,  640,  768,  896,  1024, 1280, 1536,
+                                       1792, 2048, 2560, 3072, 3584, 4096};
+static const std::size_t kNumClasses = sizeof(kClasses) / sizeof(kClasses[0]);
+
+PoolResource::PoolResource(MemoryResource *upstream, SlabCache &slabs) : _upstream(upstream) {
+    for (std::size_t i = 0; i < kNumClasses; i++) {
+        _pools.emplace_back(new Mempool(kClasses[i], slabs));
+    }
+}
+
+// See PoolResource.h
+std::size_t PoolResource::Rounded(std::size_t bytes) { return bytes <= kMaxPooled ? kClasses[_class(bytes)] : bytes; }
+
+// See PoolResource.h
+void PoolResource::Reserve(std::size_t bytes, std::size_t count) {
+    if (bytes <= kMaxPooled) {
+        _pools[_class(bytes)]->Reserve(count);
+    }
+}
+
+// See PoolResource.h
+PoolResource &PoolResource::Default() {
+    static PoolResource *instance = new PoolResource;
+    return *instance;
+}
+
+void *PoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (bytes > kMaxPooled || alignment > kMaxAlign) {
+        return _upstream->allocate(bytes, alignment);
+    }
+    return _pools[_class(bytes)]->Alloc();
+}
+
+void PoolResource::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    if (bytes > kMaxPooled || alignment > kMaxAlign) {
+        _upstream->deallocate(p, bytes, alignment);
+    } else {
+        _pools[_class(bytes)]->Free(p);
+    }
+}
+
+std::size_t PoolResource::do_footprint(std::size_t bytes, std::size_t alignment) const {
+    if (bytes > kMaxPooled || alignment > kMaxAlign) {
+        return _upstream->footprint(bytes, alignment);
+    }
+    return kClasses[_class(bytes)];
+}
+
+std::size_t PoolResource::_class(std::size_t bytes) {
+    if (bytes <= 128) {
+        return bytes == 0 ? 0 : (bytes - 1) / 16;
+    }
+
+    // Binary search over the rest, there are few classes so it stays in a cache line or two
+    std::size_t lo = 8, hi = kNumClasses - 1;
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (kClasses[mid] < bytes) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+} // namespace Allocator
+} // namespace Afina
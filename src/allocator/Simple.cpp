@@ -1,40 +1,257 @@
 #include <afina/allocator/Simple.h>
 
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
-/**
- * TODO: semantics
- * @param N size_t
- */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
-
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
-
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
-
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
-
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+// Alignment of payload returned to users
+static const size_t kAlign = alignof(std::max_align_t);
+
+struct Simple::Block {
+    // Payload size, multiple of kAlign
+    size_t size;
+
+    // Handle referring to the block, nullptr if block is free
+    void **handle;
+
+    char *data() { return reinterpret_cast<char *>(this) + sizeof(Block); }
+    char *end() { return data() + size; }
+};
+
+static size_t round_up(size_t n) { return n == 0 ? kAlign : (n + kAlign - 1) / kAlign * kAlign; }
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {
+    static_assert(sizeof(Block) % alignof(std::max_align_t) == 0, "Block header must keep payload aligned");
+
+    uintptr_t begin = reinterpret_cast<uintptr_t>(base);
+    uintptr_t end = begin + size;
+
+    begin = (begin + kAlign - 1) / kAlign * kAlign;
+    end = end / sizeof(void *) * sizeof(void *);
+    if (begin > end) {
+        begin = end;
+    }
+
+    _begin = _top = reinterpret_cast<char *>(begin);
+    _handles = _end = reinterpret_cast<void **>(end);
+    _free_handles = nullptr;
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    size_t size = round_up(N);
+    void **handle = _take_handle();
+
+    Block *block = _find_free(size);
+    if (block != nullptr) {
+        _split(block, size);
+    } else if (sizeof(Block) + size <= size_t(reinterpret_cast<char *>(_handles) - _top)) {
+        block = reinterpret_cast<Block *>(_top);
+        block->size = size;
+        _top = block->end();
+    } else {
+        _release_handle(handle);
+        throw AllocError(AllocErrorType::NoMemory, "No free block of " + std::to_string(N) + " bytes");
+    }
+
+    block->handle = handle;
+    *handle = block->data();
+    return Pointer(handle);
+}
+
+// See Simple.h
+size_t Simple::max_size() const {
+    const size_t area = reinterpret_cast<char *>(_end) - _begin;
+    if (area < sizeof(void *) + sizeof(Block)) {
+        return 0;
+    }
+    return (area - sizeof(void *) - sizeof(Block)) / kAlign * kAlign;
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._handle == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    size_t size = round_up(N);
+    Block *block = reinterpret_cast<Block *>(static_cast<char *>(*p._handle) - sizeof(Block));
+    if (size <= block->size) {
+        _split(block, size);
+        return;
+    }
+
+    // Grow in place over free neighbours or free space at the top
+    _merge_next(block);
+    if (block->size >= size) {
+        _split(block, size);
+        return;
+    }
+    if (block->end() == _top && block->data() + size <= reinterpret_cast<char *>(_handles)) {
+        block->size = size;
+        _top = block->end();
+        return;
+    }
+
+    // Move
+    Block *moved = _find_free(size);
+    if (moved != nullptr) {
+        _split(moved, size);
+    } else if (sizeof(Block) + size <= size_t(reinterpret_cast<char *>(_handles) - _top)) {
+        moved = reinterpret_cast<Block *>(_top);
+        moved->size = size;
+        _top = moved->end();
+    } else {
+        throw AllocError(AllocErrorType::NoMemory, "No free block of " + std::to_string(N) + " bytes");
+    }
+
+    std::memcpy(moved->data(), block->data(), block->size);
+    moved->handle = block->handle;
+    *moved->handle = moved->data();
+    _release(block);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._handle == nullptr) {
+        return;
+    }
+    if (p._handle < _handles || p._handle >= _end) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    char *data = static_cast<char *>(*p._handle);
+    Block *block = reinterpret_cast<Block *>(data - sizeof(Block));
+    if (data < _begin + sizeof(Block) || data > _top || block->handle != p._handle) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer is already free");
+    }
+
+    _release(block);
+    _release_handle(p._handle);
+    p._handle = nullptr;
+}
+
+// See Simple.h
+void Simple::defrag() {
+    char *dst = _begin;
+    for (char *src = _begin; src < _top;) {
+        Block *block = reinterpret_cast<Block *>(src);
+        size_t total = sizeof(Block) + block->size;
+        if (block->handle != nullptr) {
+            if (src != dst) {
+                std::memmove(dst, src, total);
+                block = reinterpret_cast<Block *>(dst);
+                *block->handle = block->data();
+            }
+            dst += total;
+        }
+        src += total;
+    }
+    _top = dst;
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::ostringstream out;
+    size_t used = 0, free = 0, blocks = 0;
+    for (char *it = _begin; it < _top;) {
+        Block *block = reinterpret_cast<Block *>(it);
+        out << "[" << (it - _begin) << ": " << block->size << (block->handle != nullptr ? " used" : " free") << "]\n";
+        if (block->handle != nullptr) {
+            used += block->size;
+        } else {
+            free += block->size;
+        }
+        blocks++;
+        it = block->end();
+    }
+
+    size_t handles = _end - _handles;
+    size_t free_handles = 0;
+    for (void **h = _free_handles; h != nullptr; h = static_cast<void **>(*h)) {
+        free_handles++;
+    }
+
+    out << blocks << " blocks, " << used << " bytes used, " << free << " bytes in free blocks, "
+        << (reinterpret_cast<char *>(_handles) - _top) << " bytes unused, " << handles << " handles ("
+        << free_handles << " free)";
+    return out.str();
+}
+
+Simple::Block *Simple::_find_free(size_t size) {
+    for (char *it = _begin; it < _top;) {
+        Block *block = reinterpret_cast<Block *>(it);
+        if (block->handle == nullptr) {
+            _merge_next(block);
+            if (block->end() == _top) {
+                // Free tail, give it back to the unused space
+                _top = it;
+                return nullptr;
+            }
+            if (block->size >= size) {
+                return block;
+            }
+        }
+        it = block->end();
+    }
+    return nullptr;
+}
+
+void Simple::_split(Block *block, size_t size) {
+    if (block->size < size + sizeof(Block) + kAlign) {
+        return;
+    }
+
+    Block *rest = reinterpret_cast<Block *>(block->data() + size);
+    rest->size = block->size - size - sizeof(Block);
+    rest->handle = nullptr;
+    block->size = size;
+    _release(rest);
+}
+
+void Simple::_merge_next(Block *block) {
+    for (Block *next = _next(block); next != nullptr && next->handle == nullptr; next = _next(block)) {
+        block->size += sizeof(Block) + next->size;
+    }
+}
+
+void Simple::_release(Block *block) {
+    block->handle = nullptr;
+    _merge_next(block);
+    if (block->end() == _top) {
+        _top = reinterpret_cast<char *>(block);
+    }
+}
+
+void **Simple::_take_handle() {
+    if (_free_handles != nullptr) {
+        void **handle = _free_handles;
+        _free_handles = static_cast<void **>(*handle);
+        return handle;
+    }
+
+    if (reinterpret_cast<char *>(_handles) - _top < ptrdiff_t(sizeof(void *))) {
+        throw AllocError(AllocErrorType::NoMemory, "No space for a new handle");
+    }
+    return --_handles;
+}
+
+void Simple::_release_handle(void **handle) {
+    *handle = _free_handles;
+    _free_handles = handle;
+}
+
+Simple::Block *Simple::_next(Block *block) const {
+    char *next = block->end();
+    return next < _top ? reinterpret_cast<Block *>(next) : nullptr;
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -0,0 +1,43 @@
+#include <afina/allocator/SlabCache.h>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr uintptr_t SlabCache::kTagMask;
+
+// See SlabCache.h
+void *SlabCache::Get() {
+    uintptr_t head = _free.load(std::memory_order_acquire);
+    while ((head & ~kTagMask) != 0) {
+        // Slab memory is never unmapped while cache is alive, so reading next of the slab
+        // already taken by someone else is safe, changed tag makes CAS fail in that case
+        FreeSlab *slab = reinterpret_cast<FreeSlab *>(head & ~kTagMask);
+        uintptr_t next = reinterpret_cast<uintptr_t>(slab->next) | ((head + 1) & kTagMask);
+        if (_free.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            _cached.fetch_sub(1, std::memory_order_relaxed);
+            return slab;
+        }
+    }
+    return _arena.Map();
+}
+
+// See SlabCache.h
+void SlabCache::Put(void *slab) {
+    FreeSlab *node = static_cast<FreeSlab *>(slab);
+    uintptr_t head = _free.load(std::memory_order_relaxed);
+    uintptr_t next;
+    do {
+        node->next = reinterpret_cast<FreeSlab *>(head & ~kTagMask);
+        next = reinterpret_cast<uintptr_t>(node) | ((head + 1) & kTagMask);
+    } while (!_free.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+    _cached.fetch_add(1, std::memory_order_relaxed);
+}
+
+// See SlabCache.h
+SlabCache &SlabCache::Default() {
+    static SlabCache *instance = new SlabCache(Arena::Default());
+    return *instance;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,146 @@
+#ifndef AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
+#define AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Work stealing deque
+ * Dynamic circular work-stealing deque by Chase and Lev, memory orders are taken from
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli).
+ *
+ * Only owner thread may call Push/Pop, which work on the bottom end. Any thread may call
+ * Steal, which takes elements from the top end. Elements are raw pointers, nullptr is
+ * reserved to report "nothing there".
+ */
+template <typename T> class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(std::size_t capacity = 1024) : _top(0), _bottom(0) {
+        std::size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        _arrays.emplace_back(new Array(cap));
+        _array.store(_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds element to the bottom end, owner only
+     */
+    void Push(T *item) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Array *a = _array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->mask)) {
+            a = Grow(a, b, t);
+        }
+        a->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Takes element from the bottom end, owner only
+     */
+    T *Pop() {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Deque was empty
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = a->Get(b);
+        if (t == b) {
+            // Last element, race against thieves
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * Takes element from the top end, could be called from any thread. Returns nullptr in case if
+     * deque is empty or other thread won the race for the element
+     */
+    T *Steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array *a = _array.load(std::memory_order_acquire);
+        T *item = a->Get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * Approximate number of elements, could be called from any thread
+     */
+    std::size_t Size() const {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    // Circular buffer of the deque, its size is always power of two
+    struct Array {
+        explicit Array(std::size_t capacity) : mask(capacity - 1), buffer(new std::atomic<T *>[capacity]) {}
+
+        T *Get(int64_t i) const { return buffer[i & mask].load(std::memory_order_relaxed); }
+        void Put(int64_t i, T *item) { buffer[i & mask].store(item, std::memory_order_relaxed); }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T *>[]> buffer;
+    };
+
+    // Doubles array size. Old arrays are kept alive until deque destruction since thieves
+    // might still read from them
+    Array *Grow(Array *old, int64_t b, int64_t t) {
+        _arrays.emplace_back(new Array((old->mask + 1) * 2));
+        Array *a = _arrays.back().get();
+        for (int64_t i = t; i < b; i++) {
+            a->Put(i, old->Get(i));
+        }
+        _array.store(a, std::memory_order_release);
+        return a;
+    }
+
+    // Index of the next element to steal
+    alignas(64) std::atomic<int64_t> _top;
+
+    // Index of the next free slot for the owner
+    alignas(64) std::atomic<int64_t> _bottom;
+
+    // Current array
+    std::atomic<Array *> _array;
+
+    // All arrays ever allocated, owned by the deque
+    std::vector<std::unique_ptr<Array>> _arrays;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
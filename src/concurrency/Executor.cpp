@@ -1,79 +1,178 @@
 #include <afina/concurrency/Executor.h>
 
+#include <stdexcept>
+
+#include "TaskPool.h"
+
 namespace Afina {
 namespace Concurrency {
 
-    void perform(Executor *executor) {
-        while (executor->state == Executor::State::kRun) {
-            std::function<void()> task;
-            {
-                std::unique_lock<std::mutex> lock(executor->mutex);
-                auto time_until = std::chrono::system_clock::now() + std::chrono::milliseconds(executor->_idle_time);
-                while (executor->tasks.empty() && executor->state == Executor::State::kRun) {
-                    executor->_free_threads++;
-                    if (executor->empty_condition.wait_until(lock, time_until) == std::cv_status::timeout) {
-                        if (executor->threads.size() > executor->_low_watermark) {
-                            executor->_erase_thread();
-                            return;
-                        }
-                        else {
-                            executor->empty_condition.wait(lock);
-                        }
-                    }
-                    executor->_free_threads--;
-                }
-                if (executor->tasks.empty()) {
-                    continue;
+// See Executor.h
+Executor::Executor(std::string name, std::size_t max_queue_size, std::size_t low_watermark,
+                   std::size_t high_watermark, std::size_t idle_time, Rejection policy)
+    : _name(std::move(name)), _tasks_head(nullptr), _tasks_tail(nullptr), _tasks_size(0), state(State::kReady),
+      _max_queue_size(max_queue_size), _low_watermark(low_watermark), _high_watermark(high_watermark),
+      _idle_time(idle_time), _policy(policy), _threads(0), _free_threads(0) {
+    if (_high_watermark == 0 || _low_watermark > _high_watermark) {
+        throw std::invalid_argument("Executor " + _name + ": low_watermark must not exceed high_watermark > 0");
+    }
+}
+
+// See Executor.h
+Executor::~Executor() {
+    Stop(true);
+
+    // Pool was never started, drop whatever was queued
+    while (_tasks_head != nullptr) {
+        TaskNode *node = _tasks_head;
+        _tasks_head = node->next;
+        TaskPool::Put(node);
+    }
+}
+
+void perform(Executor *executor) {
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    executor->_free_threads--;
+    for (;;) {
+        auto time_until = std::chrono::steady_clock::now() + executor->_idle_time;
+        bool expired = false;
+        while (executor->_tasks_size == 0 && executor->state == Executor::State::kRun) {
+            executor->_free_threads++;
+            auto status = executor->empty_condition.wait_until(lock, time_until);
+            executor->_free_threads--;
+
+            if (status == std::cv_status::timeout && executor->_tasks_size == 0) {
+                if (executor->_threads > executor->_low_watermark) {
+                    expired = true;
+                    break;
                 }
-                task = executor->tasks.front();
-                executor->tasks.pop_front();
+                time_until = std::chrono::steady_clock::now() + executor->_idle_time;
             }
-            task();
         }
-        {
-            std::unique_lock<std::mutex> lock(executor->mutex);
-            executor->_erase_thread();
-            if (executor->threads.empty()) {
-                executor->_cv_stopping.notify_all();
-            }
+
+        // Either idle for too long or pool is stopping and there is nothing left to do
+        if (expired || executor->_tasks_size == 0) {
+            break;
         }
-    }
 
-    void Executor::Start() {
-        std::unique_lock<std::mutex> lock(this->mutex);
-        for (int i = 0; i < _low_watermark; i++) {
-            threads.push_back(std::thread(&perform, this));
+        TaskNode *node = executor->_tasks_head;
+        executor->_tasks_head = node->next;
+        if (executor->_tasks_head == nullptr) {
+            executor->_tasks_tail = nullptr;
         }
-        _free_threads = 0;
-        state = State::kRun;
+        executor->_tasks_size--;
+
+        lock.unlock();
+        try {
+            node->task();
+        } catch (...) {
+            // Task failures must not kill the pool thread
+        }
+        TaskPool::Put(node);
+        lock.lock();
+    }
+
+    executor->_threads--;
+    if (executor->_threads == 0 && executor->state == Executor::State::kStopping) {
+        executor->state = Executor::State::kStopped;
+        executor->_cv_stopping.notify_all();
+    }
+}
+
+// See Executor.h
+void Executor::Start() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (state == State::kRun) {
+        return;
+    }
+
+    // Previous run is still draining, wait for it to complete before spawning new threads
+    while (state == State::kStopping) {
+        _cv_stopping.wait(lock);
+    }
+
+    state = State::kRun;
+    for (std::size_t i = 0; i < _low_watermark; i++) {
+        _add_thread();
     }
+}
 
-    void Executor::Stop(bool await) {
-        state = State::kStopping;
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (state == State::kRun) {
+        state = (_threads == 0) ? State::kStopped : State::kStopping;
         empty_condition.notify_all();
-        {
-            std::unique_lock<std::mutex> _lock(mutex);
-            while (!threads.empty()) {
-                _cv_stopping.wait(_lock);
-            }
+    }
+
+    if (await) {
+        while (state == State::kStopping) {
+            _cv_stopping.wait(lock);
         }
-        state = State::kStopped;
     }
+}
+
+// See Executor.h
+Executor::State Executor::GetState() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return state;
+}
+
+// See Executor.h
+std::size_t Executor::Threads() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return _threads;
+}
+
+// See Executor.h
+std::size_t Executor::Queued() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return _tasks_size;
+}
 
-    void Executor::_add_thread() {
-        threads.push_back(std::thread(&perform, this));
+// See Executor.h
+bool Executor::_enqueue(Task &&task) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (state != State::kRun) {
+        return false;
     }
 
-    void Executor::_erase_thread() {
-        std::thread::id this_id = std::this_thread::get_id();
-        auto iter = std::find_if(threads.begin(), threads.end(), [=](std::thread &t) { return (t.get_id() == this_id); });
-        if (iter != threads.end()) {
-            iter->detach();
-            _free_threads--;
-            threads.erase(iter);
-            return;
+    if (_tasks_size >= _max_queue_size) {
+        if (_policy == Rejection::kReject) {
+            return false;
         }
-    throw std::runtime_error("error while erasing thread");
+
+        lock.unlock();
+        task();
+        return true;
+    }
+
+    // Enqueue new task
+    TaskNode *node = TaskPool::Get();
+    node->task = std::move(task);
+    if (_tasks_tail == nullptr) {
+        _tasks_head = node;
+    } else {
+        _tasks_tail->next = node;
     }
+    _tasks_tail = node;
+    _tasks_size++;
+
+    if (_tasks_size > _free_threads && _threads < _high_watermark) {
+        _add_thread();
+    } else {
+        empty_condition.notify_one();
+    }
+    return true;
 }
+
+// See Executor.h
+void Executor::_add_thread() {
+    // Threads are detached, pool tracks them by counter and Stop(true) waits for the last one to exit
+    std::thread(&perform, this).detach();
+    _threads++;
+    _free_threads++;
+}
+
+} // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,12 @@
+#include <afina/concurrency/Histogram.h>
+
+namespace Afina {
+namespace Concurrency {
+
+constexpr std::size_t Histogram::kSubBuckets;
+constexpr std::size_t Histogram::kSubBits;
+constexpr std::size_t Histogram::kMaxExponent;
+constexpr std::size_t Histogram::kBuckets;
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,145 @@
+#include <afina/concurrency/Numa.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// From linux/mempolicy.h, libnuma isn't required for the two syscalls used
+const int kMpolPreferred = 1;
+
+// Parses sysfs cpu list like "0-3,8,10-11"
+std::vector<int> parse_cpulist(const std::string &text) {
+    std::vector<int> result;
+    std::stringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// See Numa.h
+Topology Topology::Detect() {
+    Topology result;
+
+    std::vector<int> ids;
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (dir != nullptr) {
+        while (struct dirent *entry = readdir(dir)) {
+            int id;
+            char tail;
+            if (std::sscanf(entry->d_name, "node%d%c", &id, &tail) == 1) {
+                ids.push_back(id);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (int id : ids) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+        std::string list;
+        std::getline(file, list);
+
+        Node node;
+        node.cpus = parse_cpulist(list);
+        node.memory = id;
+        // Memory only nodes have nobody to serve, skip them
+        if (!node.cpus.empty()) {
+            result._nodes.push_back(node);
+        }
+    }
+
+    if (result._nodes.empty()) {
+        Node node;
+        for (std::size_t cpu = 0; cpu < CoreLocal<int>::cpus(); cpu++) {
+            node.cpus.push_back(cpu);
+        }
+        node.memory = 0;
+        result._nodes.push_back(node);
+    }
+    return result;
+}
+
+// See Numa.h
+Topology Topology::Fake(std::size_t nodes) {
+    Topology real = Detect();
+    Topology result;
+    result._fake = true;
+    result._nodes.resize(nodes == 0 ? 1 : nodes);
+
+    std::vector<int> cpus;
+    for (auto &node : real._nodes) {
+        cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+    }
+    std::sort(cpus.begin(), cpus.end());
+
+    for (std::size_t i = 0; i < std::max(cpus.size(), result._nodes.size()); i++) {
+        result._nodes[i % result._nodes.size()].cpus.push_back(cpus[i % cpus.size()]);
+    }
+    for (std::size_t i = 0; i < result._nodes.size(); i++) {
+        result._nodes[i].memory = real._nodes[i % real._nodes.size()].memory;
+    }
+    return result;
+}
+
+// See Numa.h
+bool Topology::Bind(std::size_t node) const {
+    const Node &n = At(node);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : n.cpus) {
+        CPU_SET(cpu, &set);
+    }
+    bool ok = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+
+    unsigned long mask[16] = {0};
+    const unsigned long bits = 8 * sizeof(unsigned long);
+    if (n.memory < int(bits * 16)) {
+        mask[n.memory / bits] |= 1ul << (n.memory % bits);
+        ok = syscall(SYS_set_mempolicy, kMpolPreferred, mask, bits * 16) == 0 && ok;
+    }
+    return ok;
+}
+
+// See Numa.h
+std::string Topology::Describe() const {
+    std::stringstream out;
+    out << _nodes.size() << (_nodes.size() == 1 ? " node" : " nodes") << (_fake ? " (fake)" : "") << ":";
+    for (std::size_t i = 0; i < _nodes.size(); i++) {
+        out << (i == 0 ? " " : ", ") << "cpus";
+        for (int cpu : _nodes[i].cpus) {
+            out << " " << cpu;
+        }
+        out << " -> memory " << _nodes[i].memory;
+    }
+    return out.str();
+}
+
+} // namespace Concurrency
+} // namespace Afina
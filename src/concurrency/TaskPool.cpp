@@ -0,0 +1,151 @@
+#include "TaskPool.h"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <afina/allocator/SlabCache.h>
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// List of free nodes linked through TaskNode::next
+struct Chain {
+    TaskNode *head;
+    std::size_t size;
+};
+
+// Shared storage of free node chains. Chains are kBatch nodes long, except for ones left by exited threads
+struct Depot {
+    std::mutex mutex;
+    std::vector<Chain> chains;
+};
+
+// One depot per CPU so threads on different cores don't contend on the same mutex.
+// Never destroyed: thread caches could be flushed after static destructors run
+CoreLocal<Depot> &depots() {
+    static CoreLocal<Depot> *instance = new CoreLocal<Depot>;
+    return *instance;
+}
+
+// Takes one chain out of the depot, empty one if there is nothing
+Chain take(Depot &d) {
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if (d.chains.empty()) {
+        return Chain{nullptr, 0};
+    }
+    Chain chain = d.chains.back();
+    d.chains.pop_back();
+    return chain;
+}
+
+// Gives chain to the depot of the current CPU
+void give(Chain chain) {
+    Depot &d = depots().local();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.chains.push_back(chain);
+}
+
+// Per thread list of free nodes
+struct Cache {
+    TaskNode *head = nullptr;
+    std::size_t size = 0;
+
+    ~Cache() {
+        while (size >= TaskPool::kBatch) {
+            Flush();
+        }
+        // Executors above low watermark come and go, so the rest must not be stranded with the thread
+        if (head != nullptr) {
+            give(Chain{head, size});
+            head = nullptr;
+            size = 0;
+        }
+    }
+
+    // Moves one batch to the depot
+    void Flush() {
+        TaskNode *chain = head;
+        TaskNode *last = head;
+        for (std::size_t i = 1; i < TaskPool::kBatch; i++) {
+            last = last->next;
+        }
+        head = last->next;
+        last->next = nullptr;
+        size -= TaskPool::kBatch;
+
+        give(Chain{chain, TaskPool::kBatch});
+    }
+
+    // Brings one batch from the depot of the current CPU, then of the other ones, or cuts a new slab
+    void Refill() {
+        CoreLocal<Depot> &all = depots();
+        std::size_t cpu = CoreLocal<Depot>::current();
+        Chain chain{nullptr, 0};
+        for (std::size_t i = 0; i < all.size() && chain.head == nullptr; i++) {
+            chain = take(all.at(cpu + i));
+        }
+
+        if (chain.head == nullptr) {
+            chain = Chain{Carve(all.at(cpu)), TaskPool::kBatch};
+        }
+
+        head = chain.head;
+        size = chain.size;
+    }
+
+    // Fills slab with nodes, returns one batch and puts the rest into the depot
+    static TaskNode *Carve(Depot &d) {
+        const std::size_t chains = Allocator::Arena::kSlabSize / (sizeof(TaskNode) * TaskPool::kBatch);
+        TaskNode *nodes = static_cast<TaskNode *>(Allocator::SlabCache::Default().Get());
+        for (std::size_t i = 0; i < chains * TaskPool::kBatch; i++) {
+            new (&nodes[i]) TaskNode();
+            if ((i + 1) % TaskPool::kBatch != 0) {
+                nodes[i].next = &nodes[i + 1];
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(d.mutex);
+        for (std::size_t i = 1; i < chains; i++) {
+            d.chains.push_back(Chain{&nodes[i * TaskPool::kBatch], TaskPool::kBatch});
+        }
+        return nodes;
+    }
+};
+
+thread_local Cache cache;
+
+} // namespace
+
+constexpr std::size_t TaskPool::kBatch;
+
+// See TaskPool.h
+TaskNode *TaskPool::Get() {
+    if (cache.head == nullptr) {
+        cache.Refill();
+    }
+
+    TaskNode *node = cache.head;
+    cache.head = node->next;
+    cache.size--;
+    node->next = nullptr;
+    return node;
+}
+
+// See TaskPool.h
+void TaskPool::Put(TaskNode *node) {
+    node->task.Reset();
+    node->next = cache.head;
+    cache.head = node;
+    cache.size++;
+
+    if (cache.size >= 2 * kBatch) {
+        cache.Flush();
+    }
+}
+
+} // namespace Concurrency
+} // namespace Afina
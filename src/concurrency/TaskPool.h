@@ -0,0 +1,44 @@
+#ifndef AFINA_CONCURRENCY_TASK_POOL_H
+#define AFINA_CONCURRENCY_TASK_POOL_H
+
+#include <afina/concurrency/Task.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * Queue element for executors, tasks are linked in intrusive lists
+ */
+struct TaskNode {
+    Task task;
+    TaskNode *next = nullptr;
+};
+
+/**
+ * # Process wide pool of task nodes
+ * Each thread keeps small cache of free nodes, excess is moved in batches to the depot of the current
+ * CPU and taken back from there (or from other CPUs depots) when cache runs empty, so mutex is touched
+ * once per kBatch operations.
+ * Nodes are cut out of slabs of the default slab cache and never returned, pool size equals to
+ * max number of tasks ever in flight.
+ */
+class TaskPool {
+public:
+    // Number of nodes moved between thread cache and depot at once
+    static constexpr std::size_t kBatch = 32;
+
+    /**
+     * Takes free node, possibly allocating a new batch
+     */
+    static TaskNode *Get();
+
+    /**
+     * Returns node into the current thread cache. Task inside of the node gets destroyed
+     */
+    static void Put(TaskNode *node);
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TASK_POOL_H
@@ -0,0 +1,29 @@
+#include <afina/concurrency/Tsc.h>
+
+#include <thread>
+
+namespace Afina {
+namespace Concurrency {
+
+thread_local bool LockWait::_enabled = false;
+thread_local uint64_t LockWait::_ticks = 0;
+
+// See Tsc.h
+double Tsc::NanosPerTick() {
+    static const double rate = []() {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wall_started = std::chrono::steady_clock::now();
+        uint64_t started = Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t ticks = Now() - started;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_started);
+        return ticks > 0 ? double(ns.count()) / ticks : 1.0;
+#else
+        return 1.0;
+#endif
+    }();
+    return rate;
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,248 @@
+#include <afina/concurrency/WorkStealingExecutor.h>
+
+#include <afina/concurrency/CacheAligned.h>
+
+#include <climits>
+#include <stdexcept>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "ChaseLevDeque.h"
+#include "TaskPool.h"
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+void futex_wait(std::atomic<int> *addr, int expected) {
+    syscall(SYS_futex, reinterpret_cast<int *>(addr), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void futex_wake(std::atomic<int> *addr, int count) {
+    syscall(SYS_futex, reinterpret_cast<int *>(addr), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+// Number of failed attempts to find a task before worker parks
+const int kSpinsBeforePark = 64;
+
+} // namespace
+
+// Worker state: own deque and random generator to select victims
+class WorkStealingExecutor::Worker : public CacheAligned {
+public:
+    Worker(WorkStealingExecutor *owner, std::size_t index) : owner(owner), index(index), seed(index * 2654435761u + 1) {}
+
+    // xorshift, good enough to spread thieves across victims
+    uint32_t Random() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    WorkStealingExecutor *const owner;
+    const std::size_t index;
+    ChaseLevDeque<TaskNode> deque;
+    uint32_t seed;
+};
+
+// See WorkStealingExecutor.h
+thread_local WorkStealingExecutor::Worker *WorkStealingExecutor::_current_worker = nullptr;
+
+// See WorkStealingExecutor.h
+WorkStealingExecutor::WorkStealingExecutor(std::string name, std::size_t threads)
+    : _name(std::move(name)), _state(State::kReady), _inject_head(nullptr), _inject_tail(nullptr), _inject_size(0),
+      _epoch(0), _sleepers(0) {
+    if (threads == 0) {
+        throw std::invalid_argument("WorkStealingExecutor " + _name + ": threads must be positive");
+    }
+
+    for (std::size_t i = 0; i < threads; i++) {
+        _workers.emplace_back(new Worker(this, i));
+    }
+}
+
+// See WorkStealingExecutor.h
+WorkStealingExecutor::~WorkStealingExecutor() {
+    Stop(true);
+
+    // Pool was never started, drop whatever was queued
+    while (_inject_head != nullptr) {
+        TaskNode *node = _inject_head;
+        _inject_head = node->next;
+        TaskPool::Put(node);
+    }
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::Start() {
+    std::lock_guard<std::mutex> lock(_inject_mutex);
+    if (_state.load() != State::kReady) {
+        return;
+    }
+
+    _state.store(State::kRun);
+    for (auto &w : _workers) {
+        _threads.emplace_back(&WorkStealingExecutor::_run, this, w.get());
+    }
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::Stop(bool await) {
+    {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        State expected = State::kRun;
+        if (!_state.compare_exchange_strong(expected, State::kStopping)) {
+            if (expected == State::kReady) {
+                _state.store(State::kStopped);
+            }
+        }
+    }
+
+    // Wakeup everybody so that parked workers notice state change
+    _epoch.fetch_add(1);
+    futex_wake(&_epoch, INT_MAX);
+
+    if (await) {
+        for (auto &t : _threads) {
+            if (t.joinable() && t.get_id() != std::this_thread::get_id()) {
+                t.join();
+            }
+        }
+        _state.store(State::kStopped);
+    }
+}
+
+// See WorkStealingExecutor.h
+bool WorkStealingExecutor::_push(Task &&task) {
+    TaskNode *node = TaskPool::Get();
+    node->task = std::move(task);
+
+    Worker *self = _current_worker;
+    if (self != nullptr && self->owner == this) {
+        self->deque.Push(node);
+    } else {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        if (_state.load() != State::kRun) {
+            TaskPool::Put(node);
+            return false;
+        }
+
+        if (_inject_tail == nullptr) {
+            _inject_head = node;
+        } else {
+            _inject_tail->next = node;
+        }
+        _inject_tail = node;
+        _inject_size.fetch_add(1);
+    }
+
+    // Pairs with fence in _run: either we see a sleeper or sleeper sees our task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_relaxed) > 0) {
+        _epoch.fetch_add(1);
+        futex_wake(&_epoch, 1);
+    }
+    return true;
+}
+
+// See WorkStealingExecutor.h
+TaskNode *WorkStealingExecutor::_next(Worker *self) {
+    TaskNode *task = self->deque.Pop();
+    if (task != nullptr) {
+        return task;
+    }
+
+    if (_inject_size.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        if (_inject_head != nullptr) {
+            task = _inject_head;
+            _inject_head = task->next;
+            if (_inject_head == nullptr) {
+                _inject_tail = nullptr;
+            }
+            task->next = nullptr;
+            _inject_size.fetch_sub(1);
+            return task;
+        }
+    }
+
+    // Steal, starting from random victim go over all of them
+    std::size_t n = _workers.size();
+    std::size_t start = self->Random() % n;
+    for (std::size_t i = 0; i < n; i++) {
+        Worker *victim = _workers[(start + i) % n].get();
+        if (victim == self) {
+            continue;
+        }
+        task = victim->deque.Steal();
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+// See WorkStealingExecutor.h
+bool WorkStealingExecutor::_has_work() const {
+    if (_inject_size.load() > 0) {
+        return true;
+    }
+    for (auto &w : _workers) {
+        if (w->deque.Size() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::_run(Worker *self) {
+    _current_worker = self;
+    int spins = 0;
+    for (;;) {
+        TaskNode *node = _next(self);
+        if (node != nullptr) {
+            spins = 0;
+            try {
+                node->task();
+            } catch (...) {
+                // Task failures must not kill the pool thread
+            }
+            TaskPool::Put(node);
+            continue;
+        }
+
+        // Parking costs two syscalls, give producers a chance to come up with more work first
+        if (spins++ < kSpinsBeforePark) {
+            std::this_thread::yield();
+            continue;
+        }
+        spins = 0;
+
+        // Nothing found, prepare to park
+        int epoch = _epoch.load();
+        _sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (_has_work()) {
+            _sleepers.fetch_sub(1);
+            continue;
+        }
+
+        if (_state.load() != State::kRun) {
+            _sleepers.fetch_sub(1);
+            break;
+        }
+
+        futex_wait(&_epoch, epoch);
+        _sleepers.fetch_sub(1);
+    }
+    _current_worker = nullptr;
+}
+
+} // namespace Concurrency
+} // namespace Afina
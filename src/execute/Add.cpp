@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Add.h>
+#include <afina/execute/HotKeys.h>
 
 #include <iostream>
 
@@ -10,6 +11,7 @@ namespace Execute {
 // hold data for this key".
 void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Add(" << _key << ")" << args << std::endl;
+    HotKeys::Default().Touch(_key);
     out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
 }
 
@@ -1,5 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/HotKeys.h>
 
 #include <iostream>
 
@@ -9,13 +10,13 @@ namespace Execute {
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Append(" << _key << ")" << args << std::endl;
+    HotKeys::Default().Touch(_key);
     std::string value;
     if (!storage.Get(_key, value)) {
         out.assign("NOT_STORED");
         return;
     }
-    storage.Put(_key, value + args);
-    out.assign("STORED");
+    out.assign(storage.Put(_key, value + args) ? "STORED" : "SERVER_ERROR failed to store object");
 }
 
 } // namespace Execute
@@ -0,0 +1,110 @@
+#include <afina/execute/Batch.h>
+
+#include <exception>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Tsc.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Metrics.h>
+
+namespace Afina {
+namespace Execute {
+
+constexpr std::size_t Batch::kKeepArgument;
+
+// See Batch.h
+void Batch::Add(std::unique_ptr<Command> command, const std::string &name, std::string &args, RequestTrace &trace) {
+    if (_size == _items.size()) {
+        _items.emplace_back();
+    }
+
+    Item &item = _items[_size++];
+    item.get = dynamic_cast<Get *>(command.get());
+    item.command = std::move(command);
+    item.name = name;
+    item.args.swap(args);
+    args.clear();
+    std::swap(item.trace, trace);
+    trace.Reset();
+}
+
+// See Batch.h
+void Batch::Execute(Storage &storage, std::string &out, const Done &done) {
+    // Batch is empty even if some command throws
+    const std::size_t size = _size;
+    _size = 0;
+
+    std::string result;
+    for (std::size_t i = 0; i < size;) {
+        if (_items[i].get != nullptr) {
+            std::size_t end = i + 1;
+            while (end < size && _items[end].get != nullptr) {
+                end++;
+            }
+            _execute_gets(storage, i, end, out, done);
+            i = end;
+            continue;
+        }
+
+        Item &item = _items[i++];
+        result.clear();
+        try {
+            CommandTimer timer(item.name);
+            TracePhase execute_phase(item.trace, RequestTrace::Phase::Execute);
+            item.command->Execute(storage, item.args, result);
+        } catch (std::exception &ex) {
+            // Only this command fails, replies of the others in the batch must still go out
+            result = std::string("SERVER_ERROR ") + ex.what();
+        }
+        item.trace.Describe(item.name, *item.command, item.args.size(), result.size());
+        if (item.args.capacity() > kKeepArgument) {
+            // Large values are rare, slot shouldn't hold one until the connection closes
+            std::string().swap(item.args);
+        }
+        out += result;
+        out += "\r\n";
+        done(item.trace, result.size() + 2);
+    }
+}
+
+void Batch::_execute_gets(Storage &storage, std::size_t begin, std::size_t end, std::string &out, const Done &done) {
+    _keys.clear();
+    for (std::size_t i = begin; i < end; i++) {
+        _items[i].get->Prepare(_keys);
+    }
+
+    // Every request of the run waits for the whole lookup, metrics get an even share of it
+    const uint64_t started = Concurrency::Tsc::Now();
+    std::string error;
+    try {
+        storage.GetMany(_keys, _values, _found);
+    } catch (std::exception &ex) {
+        error = std::string("SERVER_ERROR ") + ex.what() + "\r\n";
+    }
+    const uint64_t ticks = Concurrency::Tsc::Now() - started;
+    const uint64_t share = Concurrency::Tsc::ToNanos(ticks) / (end - begin);
+
+    Metrics &metrics = Metrics::Default();
+    std::size_t first = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        Item &item = _items[i];
+        const std::size_t offset = out.size();
+        if (error.empty()) {
+            item.get->Respond(_values, _found, first, out);
+            out += "END\r\n";
+        } else {
+            out += error;
+        }
+        first += item.get->keys().size();
+
+        metrics.CommandDone(Metrics::CommandIndex(item.name), share);
+        if (item.trace.Active()) {
+            item.trace.Add(RequestTrace::Phase::Execute, ticks);
+        }
+        item.trace.Describe(item.name, *item.command, item.args.size(), out.size() - offset - 2);
+        done(item.trace, out.size() - offset);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,9 +1,7 @@
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
-
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <afina/execute/HotKeys.h>
+#include <afina/execute/Metrics.h>
 
 namespace Afina {
 namespace Execute {
@@ -22,22 +20,46 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
+    std::vector<const std::string *> keys;
+    Prepare(keys);
+
+    std::vector<std::string> values;
+    std::vector<bool> found;
+    storage.GetMany(keys, values, found);
 
-    std::stringstream outStream;
+    out.clear();
+    Respond(values, found, 0, out);
+    out += "END"; // networking layer should add the last \r\n
+}
 
-    std::string value;
+// See Get.h
+void Get::Prepare(std::vector<const std::string *> &keys) const {
+    HotKeys &hot = HotKeys::Default();
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
-            continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
+        hot.Touch(key);
+        keys.push_back(&key);
     }
-    outStream << "END"; // networking layer should add the last \r\n
+}
 
-    out = outStream.str();
+// See Get.h
+void Get::Respond(const std::vector<std::string> &values, const std::vector<bool> &found, std::size_t first,
+                  std::string &out) const {
+    Metrics &metrics = Metrics::Default();
+    for (std::size_t i = 0; i < _keys.size(); i++) {
+        if (!found[first + i]) {
+            metrics.GetMiss();
+            continue;
+        }
+        metrics.GetHit();
+        const std::string &value = values[first + i];
+        out += "VALUE ";
+        out += _keys[i];
+        out += " 0 ";
+        out += std::to_string(value.size());
+        out += "\r\n";
+        out += value;
+        out += "\r\n";
+    }
 }
 
 } // namespace Execute
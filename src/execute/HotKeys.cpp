@@ -0,0 +1,148 @@
+#include <afina/execute/HotKeys.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace Afina {
+namespace Execute {
+
+// See HotKeys.h
+void TopK::Add(const std::string &key, uint64_t weight) {
+    _total += weight;
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        _entries[it->second].count += weight;
+    } else {
+        _take(key, weight, 0);
+    }
+}
+
+// See HotKeys.h
+void TopK::Merge(const TopK &other) {
+    _total += other._total;
+    for (auto &entry : other._entries) {
+        auto it = _index.find(entry.key);
+        if (it != _index.end()) {
+            _entries[it->second].count += entry.count;
+            _entries[it->second].error += entry.error;
+        } else {
+            _take(entry.key, entry.count, entry.error);
+        }
+    }
+}
+
+// See HotKeys.h
+std::vector<TopK::Entry> TopK::Top(std::size_t n) const {
+    std::vector<Entry> result(_entries);
+    std::sort(result.begin(), result.end(), [](const Entry &a, const Entry &b) { return a.count > b.count; });
+    if (result.size() > n) {
+        result.resize(n);
+    }
+    return result;
+}
+
+// See HotKeys.h
+void TopK::Clear() {
+    _total = 0;
+    _entries.clear();
+    _index.clear();
+}
+
+void TopK::_take(const std::string &key, uint64_t weight, uint64_t error) {
+    if (_capacity == 0) {
+        return;
+    }
+    if (_entries.size() < _capacity) {
+        _index.emplace(key, _entries.size());
+        _entries.push_back(Entry{key, weight, error});
+        return;
+    }
+
+    std::size_t min = 0;
+    for (std::size_t i = 1; i < _entries.size(); i++) {
+        if (_entries[i].count < _entries[min].count) {
+            min = i;
+        }
+    }
+
+    Entry &victim = _entries[min];
+    _index.erase(victim.key);
+    victim.key = key;
+    victim.error = victim.count + error;
+    victim.count += weight;
+    _index.emplace(key, min);
+}
+
+// See HotKeys.h
+HotKeys &HotKeys::Default() {
+    // Never destroyed: workers could still touch keys after static destructors run
+    static HotKeys *instance = new HotKeys;
+    return *instance;
+}
+
+HotKeys::HotKeys()
+    : _sample_every(0), _capacity(64), _retired(64), _locals([this](Local &local) {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _retired.Merge(local.sketch);
+      }) {}
+
+// See HotKeys.h
+void HotKeys::Configure(std::size_t capacity, uint32_t sample_every) {
+    _capacity.store(capacity, std::memory_order_relaxed);
+    _sample_every.store(sample_every, std::memory_order_relaxed);
+    Reset();
+}
+
+// See HotKeys.h
+void HotKeys::Stats(std::vector<std::pair<std::string, std::string>> &stats, std::size_t n) {
+    const uint64_t every = _sample_every.load(std::memory_order_relaxed);
+    TopK merged(2 * _capacity.load(std::memory_order_relaxed));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        merged.Merge(_retired);
+    }
+    _locals.for_each([&merged](Local &local) {
+        std::lock_guard<std::mutex> lock(local.mutex);
+        merged.Merge(local.sketch);
+    });
+
+    stats.emplace_back("hotkeys_sample_every", std::to_string(every));
+    stats.emplace_back("hotkeys_sampled", std::to_string(merged.Total()));
+    for (auto &entry : merged.Top(n)) {
+        // Estimated accesses, their share of all accesses and how much the estimate could exceed the truth
+        char share[32];
+        std::snprintf(share, sizeof(share), "%.1f%%", 100.0 * entry.count / merged.Total());
+        stats.emplace_back("hotkey:" + entry.key, std::to_string(entry.count * every) + " " + share + " error " +
+                                                      std::to_string(entry.error * every));
+    }
+}
+
+// See HotKeys.h
+void HotKeys::Reset() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _retired = TopK(_capacity.load(std::memory_order_relaxed));
+    }
+    _locals.for_each([](Local &local) {
+        std::lock_guard<std::mutex> lock(local.mutex);
+        local.sketch.Clear();
+    });
+}
+
+void HotKeys::_touch(const std::string &key, uint32_t every) {
+    Local &local = _locals.get();
+    if (++local.skipped < every) {
+        return;
+    }
+    local.skipped = 0;
+
+    std::lock_guard<std::mutex> lock(local.mutex);
+    const std::size_t capacity = _capacity.load(std::memory_order_relaxed);
+    if (local.sketch.Capacity() != capacity) {
+        local.sketch = TopK(capacity);
+    }
+    local.sketch.Add(key);
+}
+
+} // namespace Execute
+} // namespace Afina
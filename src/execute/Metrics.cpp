@@ -0,0 +1,142 @@
+#include <afina/execute/Metrics.h>
+
+#include <cstdio>
+#include <ctime>
+
+#include <unistd.h>
+
+namespace Afina {
+namespace Execute {
+
+namespace {
+
+// Protocol names of the commands, in histogram order
+const char *const kNames[Metrics::kCommands] = {"get", "set", "add", "append", "stats", "other"};
+
+// Commands modifying storage, memcached counts them all as cmd_set
+const std::size_t kSetCommands[] = {1, 2, 3};
+
+// Nanoseconds as microseconds with one decimal
+std::string micros(uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f", ns / 1000.0);
+    return buf;
+}
+
+// Upper bounds of Prometheus latency buckets in nanoseconds
+const uint64_t kBounds[] = {5000,     10000,     25000,     50000,     100000,    250000,     500000,    1000000,
+                            2500000,  5000000,   10000000,  25000000,  50000000,  100000000,  250000000, 500000000,
+                            1000000000};
+
+// Nanoseconds as seconds, the base unit of Prometheus
+std::string seconds(uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", ns / 1e9);
+    return buf;
+}
+
+void sample(std::string &out, const char *name, const char *type, const char *help, int64_t value) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    out.append(name).append(" ").append(std::to_string(value)).append("\n");
+}
+
+} // namespace
+
+constexpr std::size_t Metrics::kCommands;
+
+Metrics::Metrics() : _started(std::chrono::steady_clock::now()) {}
+
+// See Metrics.h
+Metrics &Metrics::Default() {
+    // Never destroyed: threads could still report after static destructors run
+    static Metrics *instance = new Metrics;
+    return *instance;
+}
+
+// See Metrics.h
+std::size_t Metrics::CommandIndex(const std::string &name) {
+    if (name == "gets") {
+        return 0;
+    }
+    for (std::size_t i = 0; i + 1 < kCommands; i++) {
+        if (name == kNames[i]) {
+            return i;
+        }
+    }
+    return kCommands - 1;
+}
+
+// See Metrics.h
+const char *Metrics::CommandName(std::size_t index) { return kNames[index % kCommands]; }
+
+// See Metrics.h
+void Metrics::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _started);
+    int64_t cmd_set = 0;
+    for (std::size_t i : kSetCommands) {
+        cmd_set += _latency[i].Get().count;
+    }
+    const int64_t hits = _get_hits.Get();
+    const int64_t misses = _get_misses.Get();
+
+    stats.emplace_back("pid", std::to_string(getpid()));
+    stats.emplace_back("uptime", std::to_string(uptime.count()));
+    stats.emplace_back("time", std::to_string(std::time(nullptr)));
+    stats.emplace_back("curr_connections", std::to_string(_curr_connections.Get()));
+    stats.emplace_back("total_connections", std::to_string(_total_connections.Get()));
+    stats.emplace_back("cmd_get", std::to_string(hits + misses));
+    stats.emplace_back("cmd_set", std::to_string(cmd_set));
+    stats.emplace_back("get_hits", std::to_string(hits));
+    stats.emplace_back("get_misses", std::to_string(misses));
+}
+
+// See Metrics.h
+void Metrics::Latency(std::vector<std::pair<std::string, std::string>> &stats) {
+    static const std::pair<const char *, double> percentiles[] = {
+        {"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p999", 0.999}};
+
+    for (std::size_t i = 0; i < kCommands; i++) {
+        Concurrency::Histogram::Snapshot snapshot = _latency[i].Get();
+        if (snapshot.count == 0) {
+            continue;
+        }
+
+        const std::string prefix = std::string(kNames[i]) + "_";
+        stats.emplace_back(prefix + "count", std::to_string(snapshot.count));
+        for (auto &p : percentiles) {
+            stats.emplace_back(prefix + p.first + "_us", micros(snapshot.Percentile(p.second)));
+        }
+        stats.emplace_back(prefix + "max_us", micros(snapshot.Max()));
+    }
+}
+
+// See Metrics.h
+void Metrics::Prometheus(std::string &out) {
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _started);
+    sample(out, "afina_uptime_seconds", "gauge", "Time since server start", uptime.count());
+    sample(out, "afina_connections", "gauge", "Connections open at the moment", _curr_connections.Get());
+    sample(out, "afina_connections_total", "counter", "Connections accepted", _total_connections.Get());
+    sample(out, "afina_get_hits_total", "counter", "Keys found by get", _get_hits.Get());
+    sample(out, "afina_get_misses_total", "counter", "Keys not found by get", _get_misses.Get());
+
+    const char *name = "afina_command_duration_seconds";
+    out.append("# HELP ").append(name).append(" Command execution time\n");
+    out.append("# TYPE ").append(name).append(" histogram\n");
+    for (std::size_t i = 0; i < kCommands; i++) {
+        Concurrency::Histogram::Snapshot snapshot = _latency[i].Get();
+        const std::string command = std::string("command=\"") + kNames[i] + "\"";
+        for (uint64_t bound : kBounds) {
+            out.append(name).append("_bucket{").append(command).append(",le=\"").append(seconds(bound));
+            out.append("\"} ").append(std::to_string(snapshot.CountBelow(bound))).append("\n");
+        }
+        out.append(name).append("_bucket{").append(command).append(",le=\"+Inf\"} ");
+        out.append(std::to_string(snapshot.count)).append("\n");
+        out.append(name).append("_sum{").append(command).append("} ").append(seconds(snapshot.sum)).append("\n");
+        out.append(name).append("_count{").append(command).append("} ").append(std::to_string(snapshot.count));
+        out.append("\n");
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,4 +1,5 @@
 #include <afina/Storage.h>
+#include <afina/execute/HotKeys.h>
 #include <afina/execute/Replace.h>
 
 #include <iostream>
@@ -11,10 +12,10 @@ namespace Execute {
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Replace(" << _key << "): " << args << std::endl;
+    HotKeys::Default().Touch(_key);
     std::string value;
     if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
-        out = "STORED";
+        out = storage.Set(_key, args) ? "STORED" : "SERVER_ERROR failed to store object";
     } else {
         out = "NOT_STORED";
     }
@@ -1,4 +1,5 @@
 #include <afina/Storage.h>
+#include <afina/execute/HotKeys.h>
 #include <afina/execute/Set.h>
 
 #include <iostream>
@@ -9,8 +10,8 @@ namespace Execute {
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
-    out = "STORED";
+    HotKeys::Default().Touch(_key);
+    out = storage.Put(_key, args) ? "STORED" : "SERVER_ERROR failed to store object";
 }
 
 } // namespace Execute
@@ -0,0 +1,139 @@
+#include <afina/execute/SlowLog.h>
+
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Execute {
+
+constexpr std::size_t RequestTrace::kPhases;
+
+// See SlowLog.h
+ssize_t RequestTrace::Read(int fd, void *buf, std::size_t size) {
+    if (!SlowLog::Default().Enabled()) {
+        return read(fd, buf, size);
+    }
+    uint64_t started = Concurrency::Tsc::Now();
+    ssize_t result = read(fd, buf, size);
+    _last_read = Concurrency::Tsc::Now() - started;
+    return result;
+}
+
+// See SlowLog.h
+void RequestTrace::Begin() {
+    if (_open) {
+        return;
+    }
+    _open = true;
+    _active = SlowLog::Default().Enabled() && SlowLog::Default().Sample();
+    if (_active) {
+        // Request is as old as the read which brought it
+        _started = Concurrency::Tsc::Now() - _last_read;
+        Add(Phase::Read, _last_read);
+    }
+    // Next requests in the same data didn't wait for it
+    _last_read = 0;
+}
+
+// See SlowLog.h
+void RequestTrace::Describe(const std::string &name, const Command &command, std::size_t arg_size,
+                            std::size_t out_size) {
+    if (!_active) {
+        return;
+    }
+    const std::string *key = command.RoutingKey();
+    _name = name;
+    _key = key != nullptr ? *key : std::string();
+    _arg_size = arg_size;
+    _out_size = out_size;
+}
+
+// See SlowLog.h
+void RequestTrace::End() {
+    if (_active) {
+        SlowLog::Default().Report(*this);
+    }
+    Reset();
+}
+
+// See SlowLog.h
+void RequestTrace::Reset() {
+    _open = false;
+    _active = false;
+    _started = 0;
+    for (auto &t : _ticks) {
+        t = 0;
+    }
+    _arg_size = _out_size = 0;
+}
+
+// See SlowLog.h
+void PendingTraces::Queued(RequestTrace &trace, std::size_t bytes) {
+    _queued += bytes;
+    if (trace.Active()) {
+        _traces.emplace_back(_queued, trace);
+    }
+    trace.Reset();
+}
+
+// See SlowLog.h
+void PendingTraces::Written(std::size_t bytes, uint64_t ticks) {
+    _written += bytes;
+    while (!_traces.empty() && _traces.front().first <= _written) {
+        RequestTrace &trace = _traces.front().second;
+        trace.Add(RequestTrace::Phase::Write, ticks);
+        trace.End();
+        _traces.pop_front();
+    }
+}
+
+// See SlowLog.h
+SlowLog &SlowLog::Default() {
+    // Never destroyed: workers could still report after static destructors run
+    static SlowLog *instance = new SlowLog;
+    return *instance;
+}
+
+// See SlowLog.h
+void SlowLog::Configure(std::shared_ptr<spdlog::logger> logger, uint64_t threshold_us, uint32_t sample_every) {
+    // Calibrate clock now rather than in the middle of the first slow request
+    Concurrency::Tsc::NanosPerTick();
+    _logger = std::move(logger);
+    _sample_every.store(sample_every > 0 ? sample_every : 1, std::memory_order_relaxed);
+    _threshold_ns.store(threshold_us * 1000, std::memory_order_relaxed);
+}
+
+// See SlowLog.h
+bool SlowLog::Sample() {
+    static thread_local uint32_t counter = 0;
+    return counter++ % _sample_every.load(std::memory_order_relaxed) == 0;
+}
+
+// See SlowLog.h
+void SlowLog::Report(const RequestTrace &trace) {
+    using Phase = RequestTrace::Phase;
+    using Concurrency::Tsc;
+
+    const uint64_t total = Tsc::ToNanos(Tsc::Now() - trace.Started());
+    if (total < _threshold_ns.load(std::memory_order_relaxed) || !_logger) {
+        return;
+    }
+
+    // Lock wait is a part of Execute
+    const uint64_t read = Tsc::ToNanos(trace.Ticks(Phase::Read));
+    const uint64_t parse = Tsc::ToNanos(trace.Ticks(Phase::Parse));
+    const uint64_t execute = Tsc::ToNanos(trace.Ticks(Phase::Execute));
+    const uint64_t lock = Tsc::ToNanos(trace.Ticks(Phase::Lock));
+    const uint64_t write = Tsc::ToNanos(trace.Ticks(Phase::Write));
+    const uint64_t busy = read + parse + execute + write;
+    _logger->warn("{} key='{}' arg={}B out={}B total={}us: read={}us parse={}us execute={}us lock={}us write={}us "
+                  "wait={}us",
+                  trace.Name(), trace.Key(), trace.ArgSize(), trace.OutSize(), total / 1000, read / 1000,
+                  parse / 1000, execute / 1000, lock / 1000, write / 1000, (total > busy ? total - busy : 0) / 1000);
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,14 +1,43 @@
 #include <afina/Storage.h>
+#include <afina/execute/HotKeys.h>
+#include <afina/execute/Metrics.h>
 #include <afina/execute/Stats.h>
 
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::vector<std::pair<std::string, std::string>> stats;
+    const std::string group = _args.empty() ? "" : _args.front();
+    if (group.empty()) {
+        Metrics::Default().Stats(stats);
+        storage.Stats(stats);
+    } else if (group == "latency") {
+        Metrics::Default().Latency(stats);
+    } else if (group == "hotkeys") {
+        if (_args.size() > 1 && _args[1] == "reset") {
+            HotKeys::Default().Reset();
+        } else {
+            HotKeys::Default().Stats(stats);
+        }
+    } else {
+        // Client mistake, connection and the rest of the pipeline go on
+        out = "CLIENT_ERROR unknown stats group";
+        return;
+    }
+
+    out.clear();
+    for (auto &stat : stats) {
+        out.append("STAT ").append(stat.first).append(" ").append(stat.second).append("\r\n");
+    }
+    out.append("END");
+}
 
 } // namespace Execute
 } // namespace Afina
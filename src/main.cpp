@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -5,27 +6,70 @@
 #include <atomic>
 #include <semaphore.h>
 #include <signal.h>
+#include <sys/wait.h>
 #include <thread>
 
 #include <cxxopts.hpp>
 
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Pages.h>
+#include <afina/allocator/PoolResource.h>
+#include <afina/allocator/SlabCache.h>
+#include <afina/concurrency/Numa.h>
+#include <afina/execute/HotKeys.h>
+#include <afina/execute/SlowLog.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
 #include "logging/ServiceImpl.h"
+#include "network/admin/MetricsServer.h"
 #include "network/mt_blocking/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
 // #include "network/coroutine/ServerImpl.h"
 
+#include "storage/FlatCombineLRU.h"
+#include "storage/HotCache.h"
+#include "storage/Journal.h"
+#include "storage/LoggedStorage.h"
+#include "storage/MappedStorage.h"
+#include "storage/RegionLRU.h"
+#include "storage/ShardedStorage.h"
+#include "storage/Snapshot.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina;
 
+// Parses size with optional K, M or G suffix, like 64M
+static std::size_t parse_size(const std::string &text) {
+    std::size_t pos = 0;
+    unsigned long long value = std::stoull(text, &pos);
+    std::string suffix = text.substr(pos);
+    if (suffix == "K" || suffix == "k") {
+        value <<= 10;
+    } else if (suffix == "M" || suffix == "m") {
+        value <<= 20;
+    } else if (suffix == "G" || suffix == "g") {
+        value <<= 30;
+    } else if (!suffix.empty()) {
+        throw std::runtime_error("Unknown size suffix: " + text);
+    }
+    return value;
+}
+
+// Size class pools over own arena with the given pages, used to keep memory of a shard on its NUMA
+// node. Never destroyed, like the process wide ones
+static Allocator::PoolResource *node_pools(const Allocator::PagePolicy &pages, Allocator::PageKind &obtained) {
+    Allocator::Arena *arena = new Allocator::Arena(64 * Allocator::Arena::kSlabSize);
+    obtained = arena->SetPolicy(pages);
+    Allocator::SlabCache *slabs = new Allocator::SlabCache(*arena);
+    return new Allocator::PoolResource(Allocator::NewDeleteResource(), *slabs);
+}
+
 /**
  * Whole application class
  */
@@ -44,6 +88,26 @@ public:
         // logger.level = Logging::Logger::Level::WARNING;
         logger.appenders.push_back("console");
         logger.format = "[%H:%M:%S %z] [thread %t] [%n] [%l] %v";
+
+        // Slow requests go to the console along with the rest or to own file
+        if (options.count("slowlog") > 0) {
+            slowlogThreshold = options["slowlog"].as<uint64_t>();
+            if (options.count("slowlog-sample") > 0) {
+                slowlogSample = options["slowlog-sample"].as<uint32_t>();
+            }
+
+            Logging::Logger &slowlog = logConfig->loggers["slowlog"];
+            slowlog.level = Logging::Logger::Level::WARNING;
+            slowlog.format = "[%H:%M:%S.%e %z] [thread %t] [%n] %v";
+            if (options.count("slowlog-file") > 0) {
+                Logging::Appender &file = logConfig->appenders["slowlog"];
+                file.type = Logging::Appender::Type::FILE;
+                file.file = options["slowlog-file"].as<std::string>();
+                slowlog.appenders.push_back("slowlog");
+            } else {
+                slowlog.appenders.push_back("console");
+            }
+        }
         logService.reset(new Logging::ServiceImpl(logConfig));
 
         // Step 1: configure storage
@@ -52,14 +116,126 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
-        if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
-        } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+        std::size_t memory_limit = 64 << 20;
+        if (options.count("memory-limit") > 0) {
+            memory_limit = parse_size(options["memory-limit"].as<std::string>());
+        }
+
+        std::size_t shards = 1;
+        if (options.count("shards") > 0) {
+            shards = options["shards"].as<std::size_t>();
+        }
+        if (shards == 0) {
+            throw std::runtime_error("Number of shards must be positive");
+        }
+
+        std::size_t expected_items = 0;
+        if (options.count("expected-items") > 0) {
+            expected_items = options["expected-items"].as<std::size_t>();
+        }
+
+        // Pages backing storage memory: slabs of the shared arena or value regions
+        Allocator::PagePolicy pages;
+        if (options.count("huge-pages") > 0) {
+            pages.kind = Allocator::ParsePageKind(options["huge-pages"].as<std::string>());
+        }
+        pages.populate = options.count("populate") > 0;
+
+        // NUMA mode: shards are spread over nodes and keep memory there
+        if (options.count("numa") > 0) {
+            std::string mode = options["numa"].as<std::string>();
+            if (mode == "auto") {
+                numa = std::make_shared<Concurrency::Topology>(Concurrency::Topology::Detect());
+            } else {
+                numa = std::make_shared<Concurrency::Topology>(Concurrency::Topology::Fake(std::stoul(mode)));
+            }
+            // Every node gets the same number of shards
+            shards = (std::max(shards, numa->Nodes()) + numa->Nodes() - 1) / numa->Nodes() * numa->Nodes();
+        }
+
+        Allocator::PageKind obtained = Allocator::PageKind::Normal;
+        std::vector<Allocator::PoolResource *> pools(numa ? numa->Nodes() : 1, nullptr);
+        if (storage_type != "region_lru") {
+            if (numa) {
+                for (std::size_t node = 0; node < numa->Nodes(); node++) {
+                    pages.node = numa->At(node).memory;
+                    pools[node] = node_pools(pages, obtained);
+                }
+            } else if (pages.kind != Allocator::PageKind::Normal || pages.populate) {
+                obtained = Allocator::Arena::Default().SetPolicy(pages);
+            }
+        }
+
+        // File backed storage keeps one file per shard
+        std::string storage_file = "afina.storage";
+        if (options.count("storage-file") > 0) {
+            storage_file = options["storage-file"].as<std::string>();
+        }
+
+        // Limit and expected items are split evenly between shards
+        std::vector<std::shared_ptr<Afina::Storage>> parts;
+        std::vector<int> nodes;
+        for (std::size_t i = 0; i < shards; i++) {
+            const std::size_t shard_limit = memory_limit / shards;
+            const std::size_t shard_items = (expected_items + shards - 1) / shards;
+            const std::size_t node = i % pools.size();
+            if (numa) {
+                nodes.push_back(node);
+                pages.node = numa->At(node).memory;
+            }
+
+            if (storage_type == "st_lru") {
+                parts.push_back(std::make_shared<Afina::Backend::SimpleLRU>(shard_limit, shard_items, pools[node]));
+            } else if (storage_type == "mt_lru") {
+                parts.push_back(
+                    std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(shard_limit, shard_items, pools[node]));
+            } else if (storage_type == "fc_lru") {
+                parts.push_back(
+                    std::make_shared<Afina::Backend::FlatCombineLRU>(shard_limit, shard_items, pools[node]));
+            } else if (storage_type == "region_lru") {
+                auto region = std::make_shared<Afina::Backend::RegionLRU>(shard_limit, pages);
+                obtained = region->Pages();
+                parts.push_back(region);
+            } else if (storage_type == "mapped") {
+                const std::string path = shards > 1 ? storage_file + "." + std::to_string(i) : storage_file;
+                auto mapped = std::make_shared<Afina::Backend::MappedStorage>(path, shard_limit, shard_items);
+                filesReport += (filesReport.empty() ? "" : ", ") + path + " " + mapped->OpenState();
+                parts.push_back(mapped);
+            } else {
+                throw std::runtime_error("Unknown storage type");
+            }
+        }
+
+        if (parts.size() == 1) {
+            storage = parts.front();
         } else {
-            throw std::runtime_error("Unknown storage type");
+            storage = std::make_shared<Afina::Backend::ShardedStorage>(std::move(parts), std::move(nodes));
+        }
+
+        // Changes are logged ahead if journal is on
+        if (options.count("wal") > 0) {
+            journal = std::make_shared<Afina::Backend::Journal>(options["wal"].as<std::string>());
+            logged = std::make_shared<Afina::Backend::LoggedStorage>(storage, journal);
+            storage = logged;
+        }
+
+        // Reads of hot keys are served from per CPU copies, writes go through to invalidate them
+        if (options.count("hot-cache") > 0) {
+            storage = std::make_shared<Afina::Backend::HotCache>(storage);
         }
 
+        // Step 1.1: snapshot files
+        snapshotPath = "afina.snapshot";
+        if (options.count("snapshot") > 0) {
+            snapshotPath = options["snapshot"].as<std::string>();
+        }
+        if (options.count("load-snapshot") > 0) {
+            loadSnapshotPath = options["load-snapshot"].as<std::string>();
+        }
+
+        pagesReport = std::string("requested ") + Allocator::PageKindName(pages.kind) +
+                      (pages.populate ? " (populated)" : "") + ", obtained " + Allocator::PageKindName(obtained);
+
         // Step 2: Configure network
         std::string network_type = "st_block";
         if (options.count("network") > 0) {
@@ -73,12 +249,43 @@ public:
         } else if (network_type == "st_nonblock") {
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
-            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService, numa);
         // } else if (network_type == "coroutine") {
             // server = std::make_shared<Afina::Network::Coroutine::ServerImpl>(storage, logService);
         } else {
             throw std::runtime_error("Unknown network type");
         }
+
+        // Step 2.1: connection limits
+        Afina::Network::Limits limits;
+        if (options.count("max-item") > 0) {
+            limits.max_item = parse_size(options["max-item"].as<std::string>());
+        }
+        if (options.count("max-input") > 0) {
+            limits.max_input = parse_size(options["max-input"].as<std::string>());
+        }
+        if (options.count("max-output") > 0) {
+            limits.max_output = parse_size(options["max-output"].as<std::string>());
+        }
+        if (options.count("connections-memory") > 0) {
+            limits.max_memory = parse_size(options["connections-memory"].as<std::string>());
+        }
+        server->SetLimits(limits);
+
+        // Step 2.2: hot keys tracking
+        if (options.count("hotkeys") > 0) {
+            std::size_t capacity = 64;
+            if (options.count("hotkeys-size") > 0) {
+                capacity = options["hotkeys-size"].as<std::size_t>();
+            }
+            Execute::HotKeys::Default().Configure(capacity, options["hotkeys"].as<uint32_t>());
+        }
+
+        // Step 3: configure admin listener
+        if (options.count("admin-port") > 0) {
+            adminPort = options["admin-port"].as<uint16_t>();
+            admin = std::make_shared<Afina::Network::Admin::MetricsServer>(storage, server, logService);
+        }
     }
 
     // Start services in correct order
@@ -87,22 +294,101 @@ public:
         auto log = logService->select("root");
         log->warn("Start afina server {}", Afina::get_version());
 
-        log->warn("Start storage");
+        if (slowlogThreshold > 0) {
+            Execute::SlowLog::Default().Configure(logService->select("slowlog"), slowlogThreshold, slowlogSample);
+            log->warn("Log requests slower than {}us, trace one of {}", slowlogThreshold, slowlogSample);
+        }
+
+        log->warn("Start storage, memory pages: {}", pagesReport);
+        if (!filesReport.empty()) {
+            log->warn("Storage files: {}", filesReport);
+        }
         storage->Start();
 
+        if (!loadSnapshotPath.empty()) {
+            auto started = std::chrono::steady_clock::now();
+            std::size_t loaded = Backend::Snapshot::Load(*storage, loadSnapshotPath);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            log->warn("Loaded {} entries from snapshot {} in {}ms", loaded, loadSnapshotPath, ms.count());
+        }
+
+        if (logged) {
+            journal->SetLogger(log);
+            auto started = std::chrono::steady_clock::now();
+            std::size_t replayed = logged->Recover();
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            log->warn("Replayed {} journal records in {}ms, logging to segment {}", replayed, ms.count(),
+                      journal->Segment());
+        }
+
         // TODO: configure network service
         const uint16_t port = 8080;
         log->warn("Start network on {}", port);
         server->Start(port, 2, 2);
+
+        if (admin) {
+            log->warn("Start admin listener on {}, metrics at /metrics", adminPort);
+            admin->Start(adminPort);
+        }
+    }
+
+    // Writes storage snapshot in background, if there is no one in progress already
+    void Snapshot() {
+        auto log = logService->select("root");
+        if (snapshotRunning.load()) {
+            log->warn("Snapshot is in progress already, skip");
+            return;
+        }
+        if (snapshotWaiter.joinable()) {
+            snapshotWaiter.join();
+        }
+        if (!storage->CanQuiesce()) {
+            // Network threads would change it under fork
+            log->error("Storage isn't thread safe and can't be snapshotted while serving, use mt_lru, fc_lru or mapped");
+            return;
+        }
+
+        pid_t pid = Backend::Snapshot::Fork(*storage, snapshotPath);
+        log->warn("Snapshot to {} started in process {}", snapshotPath, pid);
+
+        // Journal segments before the one started by fork are covered by the snapshot
+        const uint64_t segment = journal ? journal->Segment() : 0;
+
+        snapshotRunning.store(true);
+        snapshotWaiter = std::thread([this, log, pid, segment]() {
+            auto started = std::chrono::steady_clock::now();
+            int status = 0;
+            while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+                continue;
+            }
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                log->warn("Snapshot to {} done in {}ms", snapshotPath, ms.count());
+                if (journal) {
+                    journal->Compact(segment);
+                }
+            } else {
+                log->error("Snapshot to {} failed", snapshotPath);
+            }
+            snapshotRunning.store(false);
+        });
     }
 
     // Stop services in correct order
     void Stop() {
         auto log = logService->select("root");
         log->warn("Stop application");
+        if (admin) {
+            admin->Stop();
+            admin->Join();
+        }
         server->Stop();
         server->Join();
 
+        if (snapshotWaiter.joinable()) {
+            snapshotWaiter.join();
+        }
+
         storage->Stop();
         logService->Stop();
     }
@@ -113,18 +399,56 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Afina::Network::Server> server;
+
+    // Prometheus metrics endpoint and its port, nullptr if it is off
+    std::shared_ptr<Afina::Network::Admin::MetricsServer> admin;
+    uint16_t adminPort = 0;
+
+    // What pages storage memory got from the system
+    std::string pagesReport;
+
+    // How files of the mapped storage were opened
+    std::string filesReport;
+
+    // Nodes storage and workers are spread over, nullptr if NUMA mode is off
+    std::shared_ptr<const Concurrency::Topology> numa;
+
+    // Write ahead log and storage writing to it, nullptr if journal is off
+    std::shared_ptr<Afina::Backend::Journal> journal;
+    std::shared_ptr<Afina::Backend::LoggedStorage> logged;
+
+    // Where snapshot is written on SIGUSR1 and where to load one from at start, if any
+    std::string snapshotPath;
+    std::string loadSnapshotPath;
+
+    // Requests longer than that many microseconds are logged, 0 if slowlog is off, and how often they are traced
+    uint64_t slowlogThreshold = 0;
+    uint32_t slowlogSample = 1;
+
+    // Waits for the child writing snapshot
+    std::thread snapshotWaiter;
+    std::atomic<bool> snapshotRunning{false};
 };
 
 // Signal set that to notify application about time to stop
 sem_t stop_semaphore;
 volatile sig_atomic_t stop_reason = 0;
 
+// Set by signal handler when snapshot should be written
+volatile sig_atomic_t snapshot_requested = 0;
+
 // Catch user desire to stop the server
 void on_term(int signum, siginfo_t *siginfo, void *data) {
     stop_reason = signum;
     sem_post(&stop_semaphore);
 }
 
+// Catch user desire to snapshot the storage
+void on_snapshot(int signum, siginfo_t *siginfo, void *data) {
+    snapshot_requested = 1;
+    sem_post(&stop_semaphore);
+}
+
 int main(int argc, char **argv) {
     // Command line arguments parsing
     cxxopts::Options options("afina", "Simple memory caching server");
@@ -133,6 +457,51 @@ int main(int argc, char **argv) {
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("memory-limit", "Storage memory limit in bytes, K/M/G suffixes allowed (64M by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("huge-pages", "Back storage memory by huge pages: off, thp or on (falls back to thp)",
+                              cxxopts::value<std::string>());
+        options.add_options()("populate", "Prefault storage memory at startup");
+        options.add_options()("numa", "Spread storage shards and mt_nonblock workers over NUMA nodes: auto or "
+                                      "number of fake nodes to split CPUs into",
+                              cxxopts::value<std::string>());
+        options.add_options()("shards", "Number of independent storage shards", cxxopts::value<std::size_t>());
+        options.add_options()("expected-items", "Number of entries to size storage for at startup",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("storage-file", "File of the mapped storage, suffixed by shard number if there are "
+                                               "several (afina.storage by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("snapshot", "File to write storage snapshot to on SIGUSR1 (afina.snapshot by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("load-snapshot", "Snapshot file to load storage from at startup",
+                              cxxopts::value<std::string>());
+        options.add_options()("wal", "Log storage changes ahead to segments <file>.N, replayed at startup after "
+                              "--load-snapshot",
+                              cxxopts::value<std::string>());
+        options.add_options()("slowlog", "Log requests taking longer than given number of microseconds with time "
+                                         "spent in every phase",
+                              cxxopts::value<uint64_t>());
+        options.add_options()("slowlog-sample", "Trace only one of every N requests (1 by default)",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("slowlog-file", "File to write slow requests to instead of console",
+                              cxxopts::value<std::string>());
+        options.add_options()("hotkeys", "Track most accessed keys sampling one of every N accesses, see "
+                                         "\"stats hotkeys\"",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("hotkeys-size", "Counters in the hot keys sketch of every thread (64 by default)",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("max-item", "Largest value of a storage command, K/M/G suffixes allowed, 0 for no limit "
+                                          "(1M by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("max-input", "Longest command line (64K by default)", cxxopts::value<std::string>());
+        options.add_options()("max-output", "Responses queued for a connection before it stops reading requests "
+                                            "(256K by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("connections-memory", "Memory for buffers of all connections together (256M by default)",
+                              cxxopts::value<std::string>());
+        options.add_options()("hot-cache", "Cache frequently read keys on every CPU in front of the storage");
+        options.add_options()("admin-port", "Serve Prometheus metrics at GET /metrics on this port",
+                              cxxopts::value<uint16_t>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
@@ -165,6 +534,9 @@ int main(int argc, char **argv) {
 
         sigaction(SIGINT, &act, NULL);
         sigaction(SIGTERM, &act, NULL);
+
+        act.sa_sigaction = on_snapshot;
+        sigaction(SIGUSR1, &act, NULL);
     }
 
     // Run app
@@ -172,9 +544,19 @@ int main(int argc, char **argv) {
         // Start services
         app.Start();
 
-        // Freeze main thread until one of signals arrive
-        while (stop_reason == 0 && ((sem_wait(&stop_semaphore) == -1) && (errno == EINTR))) {
-            continue;
+        // Freeze main thread until one of signals arrive, snapshot requests don't stop it
+        while (stop_reason == 0) {
+            if ((sem_wait(&stop_semaphore) == -1) && (errno == EINTR)) {
+                continue;
+            }
+            if (snapshot_requested != 0) {
+                snapshot_requested = 0;
+                try {
+                    app.Snapshot();
+                } catch (std::exception &e) {
+                    std::cerr << "Failed to start snapshot: " << e.what() << std::endl;
+                }
+            }
         }
 
         // Stop services
@@ -0,0 +1,58 @@
+#include <afina/network/Limits.h>
+
+#include <sys/socket.h>
+
+namespace Afina {
+namespace Network {
+
+// See Limits.h
+void ReplyLimitExceeded(int socket, const LimitExceeded &ex) {
+    const std::string reply = std::string("SERVER_ERROR ") + ex.what() + "\r\n";
+    send(socket, reply.data(), reply.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+constexpr std::size_t ConnectionMemory::kStep;
+
+bool ConnectionMemory::_reserve(std::size_t size) {
+    const std::size_t used = _used.fetch_add(size, std::memory_order_relaxed) + size;
+    if (_limits.max_memory != 0 && used > _limits.max_memory) {
+        _used.fetch_sub(size, std::memory_order_relaxed);
+        _rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// See Limits.h
+ConnectionGuard::ConnectionGuard(ConnectionMemory &memory) : _memory(memory), _reserved(0) { Use(0); }
+
+// See Limits.h
+void ConnectionGuard::Line(std::size_t size) const {
+    if (_memory._limits.max_input != 0 && size > _memory._limits.max_input) {
+        throw LimitExceeded("command line too long");
+    }
+}
+
+// See Limits.h
+void ConnectionGuard::Item(std::size_t size) const {
+    if (_memory._limits.max_item != 0 && size > _memory._limits.max_item) {
+        throw LimitExceeded("object too large for cache");
+    }
+}
+
+// See Limits.h
+void ConnectionGuard::Use(std::size_t size) {
+    const std::size_t step = ConnectionMemory::kStep;
+    const std::size_t needed = (size / step + 1) * step;
+    if (needed > _reserved) {
+        if (!_memory._reserve(needed - _reserved)) {
+            throw LimitExceeded("out of memory for connections");
+        }
+    } else if (needed < _reserved) {
+        _memory._release(_reserved - needed);
+    }
+    _reserved = needed;
+}
+
+} // namespace Network
+} // namespace Afina
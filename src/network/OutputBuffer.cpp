@@ -0,0 +1,98 @@
+#include <afina/network/OutputBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <afina/allocator/Mempool.h>
+
+namespace Afina {
+namespace Network {
+
+namespace {
+
+// Never destroyed: connections could outlive static destructors
+Allocator::Mempool &chunk_pool() {
+    static Allocator::Mempool *pool = new Allocator::Mempool(OutputBuffer::kChunkSize);
+    return *pool;
+}
+
+} // namespace
+
+constexpr std::size_t OutputBuffer::kChunkSize;
+constexpr std::size_t OutputBuffer::kCapacity;
+
+// See OutputBuffer.h
+void OutputBuffer::Append(const char *data, std::size_t size) {
+    _size += size;
+    while (size > 0) {
+        if (_tail == nullptr || _tail->end == kCapacity) {
+            _grow();
+        }
+        std::size_t part = std::min(size, kCapacity - _tail->end);
+        std::memcpy(_tail->data + _tail->end, data, part);
+        _tail->end += part;
+        data += part;
+        size -= part;
+    }
+}
+
+// See OutputBuffer.h
+int OutputBuffer::Prepare(struct iovec *iov, int max) const {
+    int count = 0;
+    for (Chunk *chunk = _head; chunk != nullptr && count < max; chunk = chunk->next) {
+        iov[count].iov_base = chunk->data + chunk->begin;
+        iov[count].iov_len = chunk->end - chunk->begin;
+        count++;
+    }
+    return count;
+}
+
+// See OutputBuffer.h
+void OutputBuffer::Consume(std::size_t size) {
+    _size -= size;
+    while (size > 0) {
+        std::size_t part = std::min(size, _head->end - _head->begin);
+        _head->begin += part;
+        size -= part;
+
+        // Chunk still being filled stays even when sent completely
+        if (_head->begin == _head->end && (_head != _tail || _head->end == kCapacity)) {
+            Chunk *sent = _head;
+            _head = sent->next;
+            if (_head == nullptr) {
+                _tail = nullptr;
+            }
+            chunk_pool().Free(sent);
+        }
+    }
+    if (_size == 0 && _head != nullptr) {
+        // Start over in the only chunk left
+        _head->begin = _head->end = 0;
+    }
+}
+
+// See OutputBuffer.h
+void OutputBuffer::Clear() {
+    while (_head != nullptr) {
+        Chunk *next = _head->next;
+        chunk_pool().Free(_head);
+        _head = next;
+    }
+    _tail = nullptr;
+    _size = 0;
+}
+
+void OutputBuffer::_grow() {
+    Chunk *chunk = static_cast<Chunk *>(chunk_pool().Alloc());
+    chunk->next = nullptr;
+    chunk->begin = chunk->end = 0;
+    if (_tail != nullptr) {
+        _tail->next = chunk;
+    } else {
+        _head = chunk;
+    }
+    _tail = chunk;
+}
+
+} // namespace Network
+} // namespace Afina
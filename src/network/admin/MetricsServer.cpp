@@ -0,0 +1,203 @@
+#include "MetricsServer.h"
+
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/execute/Metrics.h>
+#include <afina/logging/Service.h>
+#include <afina/network/Server.h>
+
+namespace Afina {
+namespace Network {
+namespace Admin {
+
+namespace {
+
+// Requests are tiny, anything longer is not a scrape
+const std::size_t kMaxRequest = 8192;
+
+// Appends name/value pairs with numeric values as untyped samples, names made Prometheus safe
+void untyped(std::string &out, const std::string &prefix,
+             const std::vector<std::pair<std::string, std::string>> &stats) {
+    for (auto &stat : stats) {
+        char *end = nullptr;
+        std::strtod(stat.second.c_str(), &end);
+        if (stat.second.empty() || *end != '\0') {
+            continue;
+        }
+
+        std::string name = prefix + stat.first;
+        for (char &c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                c = '_';
+            }
+        }
+        out.append("# TYPE ").append(name).append(" untyped\n");
+        out.append(name).append(" ").append(stat.second).append("\n");
+    }
+}
+
+bool send_all(int socket, const std::string &data) {
+    for (std::size_t sent = 0; sent < data.size();) {
+        ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Server> server,
+                             std::shared_ptr<Logging::Service> pl)
+    : pStorage(std::move(ps)), pServer(std::move(server)), pLogging(std::move(pl)), running(false),
+      _server_socket(-1) {}
+
+MetricsServer::~MetricsServer() {}
+
+// See MetricsServer.h
+void MetricsServer::Start(uint16_t port) {
+    _logger = pLogging->select("network");
+    _logger->info("Start admin listener");
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+
+    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open admin socket");
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Admin socket setsockopt() failed");
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Admin socket bind() failed");
+    }
+
+    if (listen(_server_socket, 5) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Admin socket listen() failed");
+    }
+
+    running.store(true);
+    _thread = std::thread(&MetricsServer::OnRun, this);
+}
+
+// See MetricsServer.h
+void MetricsServer::Stop() {
+    running.store(false);
+    shutdown(_server_socket, SHUT_RDWR);
+}
+
+// See MetricsServer.h
+void MetricsServer::Join() {
+    assert(_thread.joinable());
+    _thread.join();
+    close(_server_socket);
+}
+
+// See MetricsServer.h
+std::string MetricsServer::Render() {
+    std::string out;
+    Execute::Metrics::Default().Prometheus(out);
+
+    std::vector<std::pair<std::string, std::string>> stats;
+    pStorage->Stats(stats);
+    untyped(out, "afina_storage_", stats);
+
+    if (pServer) {
+        stats.clear();
+        pServer->Stats(stats);
+        untyped(out, "afina_network_", stats);
+    }
+    return out;
+}
+
+void MetricsServer::OnRun() {
+    while (running.load()) {
+        int client_socket = accept(_server_socket, nullptr, nullptr);
+        if (client_socket == -1) {
+            continue;
+        }
+
+        // Slow client must not hang the listener forever
+        struct timeval tv;
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
+        setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&tv, sizeof tv);
+
+        try {
+            Serve(client_socket);
+        } catch (std::exception &ex) {
+            _logger->error("Failed to serve scrape: {}", ex.what());
+        }
+        close(client_socket);
+    }
+    _logger->warn("Admin listener stopped");
+}
+
+void MetricsServer::Serve(int client_socket) {
+    // Only the request line matters, rest of headers are read and ignored
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequest) {
+        ssize_t n = read(client_socket, buffer, sizeof(buffer));
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+            break;
+        }
+        request.append(buffer, n);
+    }
+
+    std::string status = "200 OK", body;
+    const std::string path = "GET /metrics";
+    if (request.compare(0, path.size(), path) == 0 && request.size() > path.size() &&
+        (request[path.size()] == ' ' || request[path.size()] == '?')) {
+        body = Render();
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body = "Try /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    if (!send_all(client_socket, response)) {
+        throw std::runtime_error("Failed to send response");
+    }
+}
+
+} // namespace Admin
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,79 @@
+#ifndef AFINA_NETWORK_ADMIN_METRICS_SERVER_H
+#define AFINA_NETWORK_ADMIN_METRICS_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+class Storage;
+namespace Logging {
+class Service;
+}
+namespace Network {
+class Server;
+namespace Admin {
+
+/**
+ * # Admin listener
+ * Serves GET /metrics in Prometheus text format on its own port and thread, so scraping never
+ * competes with client connections. Every value is read from per CPU counters or via Stats() of
+ * storage and network, nothing on the request path is locked for that.
+ */
+class MetricsServer {
+public:
+    MetricsServer(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Server> server,
+                  std::shared_ptr<Logging::Service> pl);
+    ~MetricsServer();
+
+    /**
+     * Starts listening on the given port
+     */
+    void Start(uint16_t port);
+
+    /**
+     * Stops accepting scrapes, pending one is completed
+     */
+    void Stop();
+
+    /**
+     * Waits for the listener thread to exit
+     */
+    void Join();
+
+    /**
+     * Current values of all metrics in Prometheus text format
+     */
+    std::string Render();
+
+private:
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    // Accepts scrapes one by one
+    void OnRun();
+
+    // Reads request from the client and writes response
+    void Serve(int client_socket);
+
+    std::shared_ptr<Afina::Storage> pStorage;
+    std::shared_ptr<Server> pServer;
+    std::shared_ptr<Logging::Service> pLogging;
+
+    std::shared_ptr<spdlog::logger> _logger;
+
+    std::atomic<bool> running;
+    int _server_socket;
+    std::thread _thread;
+};
+
+} // namespace Admin
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ADMIN_METRICS_SERVER_H
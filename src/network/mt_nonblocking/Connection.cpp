@@ -1,11 +1,35 @@
 #include "Connection.h"
 
 #include <iostream>
+#include <unistd.h>
+
+#include <afina/allocator/Mempool.h>
+#include <afina/concurrency/ThreadLocal.h>
+#include <afina/concurrency/Tsc.h>
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+namespace {
+
+// Scratch space of worker threads for responses of a batch, keeps its capacity between events
+Concurrency::ThreadLocal<std::string> batch_output;
+
+// Never destroyed: connections could outlive static destructors
+Allocator::Mempool &connection_pool() {
+    static Allocator::Mempool *pool = new Allocator::Mempool(sizeof(Connection));
+    return *pool;
+}
+
+} // namespace
+
+// See Connection.h
+void *Connection::operator new(std::size_t size) { return connection_pool().Alloc(); }
+
+// See Connection.h
+void Connection::operator delete(void *ptr) { connection_pool().Free(ptr); }
+
 // See Connection.h
 void Connection::Start(std::shared_ptr<spdlog::logger> logger) {
     _event.events = mask_read;
@@ -31,107 +55,169 @@ void Connection::OnClose() {
 void Connection::DoRead() {
     std::lock_guard<std::mutex> _lock(_mutex);
     try {
+        // Input left by worker of another node
+        _process();
+
         int readed_bytes_new = -1;
-        while ((readed_bytes_new = read(_socket, client_buffer + readed_bytes, sizeof(client_buffer) - readed_bytes)) >
-               0) {
+        while (_migrate_to < 0 && !_paused() && (readed_bytes_new = _trace.Read(_socket, client_buffer + readed_bytes,
+                                                             sizeof(client_buffer) - readed_bytes)) > 0) {
             readed_bytes += readed_bytes_new;
-            while (readed_bytes > 0) {
-                // There is no command yet
-                if (!command_to_execute) {
-                    std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, readed_bytes, parsed)) {
-                        // There is no command to be launched, continue to parse input stream
-                        // Here we are, current chunk finished some command, process it
-                        command_to_execute = parser.Build(arg_remains);
-                        if (arg_remains > 0) {
-                            arg_remains += 2;
-                        }
-                    }
-
-                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
-                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
-                    if (parsed == 0) {
-                        break;
-                    } else {
-                        std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
-                    }
+            _stats->bytes_read.Add(readed_bytes_new);
+            _process();
+        }
+    } catch (LimitExceeded &ex) {
+        _reject(ex);
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
+    }
+}
+
+void Connection::_process() {
+    while (_migrate_to < 0 && !_paused()) {
+        // There is no command yet
+        if (!command_to_execute) {
+            if (readed_bytes == 0) {
+                break;
+            }
+
+            std::size_t parsed = 0;
+            _trace.Begin();
+            Execute::TracePhase parse_phase(_trace, Execute::RequestTrace::Phase::Parse);
+            if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                // There is no command to be launched, continue to parse input stream
+                // Here we are, current chunk finished some command, process it
+                command_to_execute = parser.Build(arg_remains);
+                if (arg_remains > 0) {
+                    _guard.Item(arg_remains);
+                    _guard.Use(arg_remains + _output.Size());
+                    arg_remains += 2;
                 }
+            }
+            _guard.Line(parser.Consumed());
+
+            // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+            // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+            if (parsed == 0) {
+                break;
+            } else {
+                std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
+                readed_bytes -= parsed;
+            }
+        }
 
-                // There is command, but we still wait for argument to arrive...
-                if (command_to_execute && arg_remains > 0) {
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            if (readed_bytes == 0) {
+                break;
+            }
 
-                    std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
-                    arg_remains -= to_read;
-                    readed_bytes -= to_read;
-                }
+            // There is some parsed command, and now we are reading argument
+            std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
+            argument_for_command.append(client_buffer, to_read);
 
-                // Thre is command & argument - RUN!
-                if (command_to_execute && arg_remains == 0) {
-                    std::string result;
-                    command_to_execute->Execute(*pStorage, argument_for_command, result);
-                    result += "\r\n";
-
-                    // Save response
-                    {
-                        // std::lock_guard<std::mutex> lock(_mutex);
-                        _answers.push_back(result);
-                        _event.events = mask_read_write;
-                    }
-
-                    // Prepare for the next command
-                    command_to_execute.reset();
-                    argument_for_command.resize(0);
-                    parser.Reset();
-                }
-            } // while (readed_bytes)
+            std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+            arg_remains -= to_read;
+            readed_bytes -= to_read;
+        }
+
+        // Thre is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            if (_route()) {
+                break;
+            }
+
+            // Prepare for the next command
+            _batch.Add(std::move(command_to_execute), parser.Name(), argument_for_command, _trace);
+            parser.Reset();
+            if (_batch.Size() >= kBatchSlice) {
+                _execute();
+            }
         }
-    } catch (std::runtime_error &ex) {
-        _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
     }
+
+    _execute();
+    _event.events = _mask();
 }
 
-// See Connection.h
-void Connection::DoWrite() {
-    struct iovec *iovecs;
-    std::size_t ans_size;
-    {
-        std::lock_guard<std::mutex> _lock(_mutex);
-        ans_size = _answers.size();
-        iovecs = new struct iovec[ans_size];
-        for (int i = 0; i < _answers.size(); i++) {
-            iovecs[i].iov_len = _answers[i].size();
-            iovecs[i].iov_base = &(_answers[i][0]);
-        }
+void Connection::_execute() {
+    if (_batch.Empty()) {
+        return;
     }
-    iovecs[0].iov_base = static_cast<char *>(iovecs[0].iov_base) + _position;
 
-    assert(iovecs[0].iov_len > _position);
-    iovecs[0].iov_len -= _position;
+    std::string &out = batch_output.get();
+    out.clear();
+    _batch.Execute(*pStorage, out, [this](Execute::RequestTrace &trace, std::size_t size) {
+        _stats->commands.Add();
+        _traces.Queued(trace, size);
+    });
+    _output.Append(out);
+    _guard.Use(_output.Size());
+    if (_paused()) {
+        _stats->output_paused.Add();
+    }
+}
 
-    int written;
-    if ((written = writev(_socket, iovecs, ans_size)) <= 0) {
-        _logger->error("Failed to send response");
+void Connection::_reject(const LimitExceeded &ex) {
+    _logger->warn("Close connection on descriptor {} : {}", _socket, ex.what());
+    ReplyLimitExceeded(_socket, ex);
+    OnError();
+}
+
+int Connection::_mask() const {
+    if (_output.Empty()) {
+        return mask_read;
     }
-    _position += written;
+    return _paused() ? mask_write : mask_read_write;
+}
 
-    int i = 0;
-    for (; i < ans_size && (_position - iovecs[i].iov_len) >= 0; i++) {
-        assert(_position >= iovecs[i].iov_len);
-        _position -= iovecs[i].iov_len;
+bool Connection::_route() {
+    if (_node < 0) {
+        return false;
+    }
+    const std::string *key = command_to_execute->RoutingKey();
+    int owner = key != nullptr ? pStorage->NodeOf(*key) : -1;
+    if (owner < 0 || owner == _node) {
+        return false;
     }
+    _migrate_to = owner;
+    return true;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        _answers.erase(_answers.begin(), _answers.begin() + i);
-        if (_answers.empty()) {
-            _event.events = mask_read;
+// See Connection.h
+void Connection::DoWrite() {
+    std::lock_guard<std::mutex> _lock(_mutex);
+    if (_output.Empty()) {
+        // Woken up after move to another node or pause with nothing to send
+        _event.events = _mask();
+        return;
+    }
+
+    struct iovec iovecs[kMaxIovecs];
+    int count = _output.Prepare(iovecs, kMaxIovecs);
+
+    uint64_t started = Concurrency::Tsc::Now();
+    ssize_t written = writev(_socket, iovecs, count);
+    if (written <= 0) {
+        _logger->error("Failed to send response");
+        return;
+    }
+    _stats->bytes_written.Add(written);
+    _traces.Written(written, Concurrency::Tsc::Now() - started);
+
+    const bool paused = _paused();
+    _output.Consume(written);
+    _guard.Use(_output.Size());
+    if (paused && !_paused()) {
+        // Input read before the pause
+        try {
+            _process();
+        } catch (LimitExceeded &ex) {
+            _reject(ex);
+        } catch (std::runtime_error &ex) {
+            _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
         }
     }
-    delete[] iovecs;
+    _event.events = _mask();
 }
 } // namespace MTnonblock
 } // namespace Network
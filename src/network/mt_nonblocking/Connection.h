@@ -9,9 +9,15 @@
 #include <sys/uio.h>
 #include <vector>
 
+#include "Statistics.h"
 #include "protocol/Parser.h"
 #include <afina/Storage.h>
+#include <afina/execute/Batch.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Metrics.h>
+#include <afina/execute/SlowLog.h>
+#include <afina/network/Limits.h>
+#include <afina/network/OutputBuffer.h>
 #include <spdlog/logger.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
@@ -26,15 +32,22 @@ namespace MTnonblock {
 
 class Connection {
 public:
-    Connection(int s, std::shared_ptr<Afina::Storage> ps) : _socket(s), pStorage(ps) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, Statistics *stats, ConnectionMemory &memory)
+        : _socket(s), pStorage(ps), _stats(stats), _guard(memory) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _isAlive.store(true);
+        Execute::Metrics::Default().ConnectionOpened();
     }
+    ~Connection() { Execute::Metrics::Default().ConnectionClosed(); }
 
     inline bool isAlive() const { return _isAlive.load(); }
 
     void Start(std::shared_ptr<spdlog::logger> logger);
 
+    // Connections come from the shared mempool instead of malloc
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr);
+
 protected:
     void OnError();
     void OnClose();
@@ -42,15 +55,49 @@ protected:
     void DoWrite();
 
 private:
+    // Parses commands complete in the input already in the buffer and executes them in batches of
+    // up to kBatchSlice, stops early if connection needs to move to another node or output is paused
+    void _process();
+
+    // Executes commands batched so far and queues their responses
+    void _execute();
+
+    // Decides whether pending command should rather run on another node, see _migrate_to
+    bool _route();
+
+    // Whether there is input read but not processed yet
+    bool _has_input() const { return readed_bytes > 0 || command_to_execute; }
+
+    // Whether client reads responses slower than it sends requests: neither socket nor input read
+    // already are touched until output drains below the limit
+    bool _paused() const { return _guard.Paused(_output.Size()); }
+
+    // Closes connection of the client which went over a limit
+    void _reject(const LimitExceeded &ex);
+
+    // Events to wait for given the state of buffers
+    int _mask() const;
+
     friend class Worker;
     friend class ServerImpl;
 
     static const int mask_read = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLONESHOT;
     static const int mask_read_write = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLOUT | EPOLLONESHOT;
+    static const int mask_write = EPOLLRDHUP | EPOLLERR | EPOLLOUT | EPOLLONESHOT;
+
+    // Max number of chunks sent by one writev
+    static constexpr int kMaxIovecs = 64;
+
+    // Max number of commands executed before output is checked against the limit again, so that
+    // long pipeline of large gets doesn't queue all of its responses at once
+    static constexpr std::size_t kBatchSlice = 32;
 
     std::shared_ptr<spdlog::logger> _logger;
     std::shared_ptr<Afina::Storage> pStorage;
 
+    // Server wide counters
+    Statistics *_stats;
+
     std::mutex _mutex;
     std::atomic<bool> _sync_read;
 
@@ -58,16 +105,32 @@ private:
     std::atomic<bool> _isAlive;
     struct epoll_event _event;
 
+    // Limits of the client
+    ConnectionGuard _guard;
+
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
 
+    // Request being read and requests waiting for their responses to be written
+    Execute::RequestTrace _trace;
+    Execute::PendingTraces _traces;
+
     int readed_bytes = 0;
     char client_buffer[4096];
 
-    std::vector<std::string> _answers;
-    int _position = 0;
+    // Commands parsed from the input at hand, executed once there is nothing more to parse
+    Execute::Batch _batch;
+
+    // Responses not written yet
+    OutputBuffer _output;
+
+    // NUMA node which epoll connection is registered in, -1 if NUMA mode is off
+    int _node = -1;
+
+    // Node connection wants to be moved to before executing pending command, -1 if none
+    int _migrate_to = -1;
 };
 
 } // namespace MTnonblock
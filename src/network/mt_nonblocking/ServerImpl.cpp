@@ -30,7 +30,9 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+                       std::shared_ptr<const Concurrency::Topology> numa)
+    : Server(ps, pl), _next_node(0), _numa(numa) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -77,27 +79,39 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+    const std::size_t nodes = _numa ? _numa->Nodes() : 1;
+    for (std::size_t i = 0; i < nodes; i++) {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+        _data_epoll_fds.push_back(epoll_fd);
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+    }
+
+    // Every node needs someone to serve it
+    if (n_workers < nodes) {
+        n_workers = nodes;
+    }
+    if (_numa) {
+        _logger->info("NUMA mode: {}", _numa->Describe());
     }
 
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging, _conns);
-        _workers.back().Start(_data_epoll_fd);
+        _workers.emplace_back(pStorage, pLogging, _conns, &_stats, _numa);
+        _workers.back().Start(_data_epoll_fds, i % nodes);
     }
 
     // Start acceptors
@@ -130,6 +144,25 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    _logger->info("Network stats: connections accepted={} closed={}, bytes read={} written={}, commands={}, "
+                  "output pauses={}, node migrations={}",
+                  _stats.connections_accepted.Get(), _stats.connections_closed.Get(), _stats.bytes_read.Get(),
+                  _stats.bytes_written.Get(), _stats.commands.Get(), _stats.output_paused.Get(),
+                  _stats.migrations.Get());
+}
+
+// See Server.h
+void ServerImpl::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    Server::Stats(stats);
+    stats.emplace_back("connections_accepted", std::to_string(_stats.connections_accepted.Get()));
+    stats.emplace_back("connections_closed", std::to_string(_stats.connections_closed.Get()));
+    stats.emplace_back("bytes_read", std::to_string(_stats.bytes_read.Get()));
+    stats.emplace_back("bytes_written", std::to_string(_stats.bytes_written.Get()));
+    stats.emplace_back("commands", std::to_string(_stats.commands.Get()));
+    stats.emplace_back("output_paused", std::to_string(_stats.output_paused.Get()));
+    stats.emplace_back("migrations", std::to_string(_stats.migrations.Get()));
+    stats.emplace_back("workers", std::to_string(_workers.size()));
 }
 
 // See ServerImpl.h
@@ -193,17 +226,28 @@ void ServerImpl::OnRun() {
                 }
 
                 // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd, pStorage);
+                Connection *pc;
+                try {
+                    pc = new Connection(infd, pStorage, &_stats, *pMemory);
+                } catch (LimitExceeded &ex) {
+                    _logger->warn("Reject connection on descriptor {} : {}", infd, ex.what());
+                    ReplyLimitExceeded(infd, ex);
+                    close(infd);
+                    continue;
+                }
+                _stats.connections_accepted.Add();
                 _conns.insert(pc);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
 
-                // Register connection in worker's epoll
+                // Register connection in worker's epoll, nodes take new connections in turn
+                std::size_t node = _next_node.fetch_add(1, std::memory_order_relaxed) % _data_epoll_fds.size();
                 pc->Start(_logger);
+                pc->_node = _numa ? int(node) : -1;
                 if (pc->isAlive()) {
                     // pc->_event.events |= EPOLLONESHOT;
-                    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                    if (epoll_ctl(_data_epoll_fds[node], EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
                         _logger->error("Can't register connection in worker's epoll");
                         pc->OnError();
                         _conns.erase(pc);
@@ -1,11 +1,14 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <atomic>
 #include <set>
 #include <thread>
 #include <vector>
 
 #include "Connection.h"
+#include "Statistics.h"
+#include <afina/concurrency/Numa.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -22,10 +25,14 @@ class Worker;
 /**
  * # Network resource manager implementation
  * Epoll based server
+ *
+ * In NUMA mode there is an epoll per node served by workers bound to that node. Connection is handed
+ * over to another node when its next command is for a key stored there, see Storage::NodeOf
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+               std::shared_ptr<const Concurrency::Topology> numa = nullptr);
     ~ServerImpl();
 
     // See Server.h
@@ -37,6 +44,9 @@ public:
     // See Server.h
     void Join() override;
 
+    // See Server.h
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
 protected:
     void OnRun();
 
@@ -56,8 +66,14 @@ private:
     // but share global server socket
     std::vector<std::thread> _acceptors;
 
-    // EPOLL instance shared between workers
-    int _data_epoll_fd;
+    // EPOLL instances shared between workers, one per NUMA node or just one if NUMA mode is off
+    std::vector<int> _data_epoll_fds;
+
+    // Node of the next accepted connection
+    std::atomic<std::size_t> _next_node;
+
+    // Nodes to bind workers to, nullptr if NUMA mode is off
+    std::shared_ptr<const Concurrency::Topology> _numa;
 
     // Curstom event "device" used to wakeup workers
     int _event_fd;
@@ -66,6 +82,9 @@ private:
     std::vector<Worker> _workers;
 
     std::set<Connection *> _conns;
+
+    // Counters shared by acceptors, workers and connections
+    Statistics _stats;
 };
 
 } // namespace MTnonblock
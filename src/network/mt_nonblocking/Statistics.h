@@ -0,0 +1,33 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_STATISTICS_H
+#define AFINA_NETWORK_MT_NONBLOCKING_STATISTICS_H
+
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+/**
+ * # Server counters
+ * Updated by acceptors and workers on every event, so each counter is per CPU to keep
+ * workers from fighting for the same cache line
+ */
+struct Statistics {
+    Concurrency::CoreCounter connections_accepted;
+    Concurrency::CoreCounter connections_closed;
+    Concurrency::CoreCounter bytes_read;
+    Concurrency::CoreCounter bytes_written;
+    Concurrency::CoreCounter commands;
+
+    // Times connection stopped reading because its client didn't read responses
+    Concurrency::CoreCounter output_paused;
+
+    // Connections handed over to workers of another NUMA node to run command near its data
+    Concurrency::CoreCounter migrations;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_STATISTICS_H
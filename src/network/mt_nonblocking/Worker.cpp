@@ -22,8 +22,9 @@ namespace MTnonblock {
 
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,
-               std::set<Connection *> &_conns)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _conns(_conns) {
+               std::set<Connection *> &_conns, Statistics *stats, std::shared_ptr<const Concurrency::Topology> numa)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _node(0), _numa(numa), _conns(_conns),
+      _stats(stats) {
     // TODO: implementation here
 }
 
@@ -33,7 +34,7 @@ Worker::~Worker() {
 }
 
 // See Worker.h
-Worker::Worker(Worker &&other) : _conns(other._conns) { *this = std::move(other); }
+Worker::Worker(Worker &&other) : _conns(other._conns), _stats(other._stats) { *this = std::move(other); }
 
 // See Worker.h
 Worker &Worker::operator=(Worker &&other) {
@@ -42,16 +43,22 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _epoll_fds = std::move(other._epoll_fds);
+    _node = other._node;
+    _numa = std::move(other._numa);
+    _stats = other._stats;
 
     other._epoll_fd = -1;
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(const std::vector<int> &epoll_fds, std::size_t node) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
-        _epoll_fd = epoll_fd;
+        _epoll_fds = epoll_fds;
+        _node = node;
+        _epoll_fd = _epoll_fds.at(node);
         _logger = _pLogging->select("network.worker");
         _thread = std::thread(&Worker::OnRun, this);
     }
@@ -71,6 +78,10 @@ void Worker::OnRun() {
     assert(_epoll_fd >= 0);
     _logger->trace("OnRun");
 
+    if (_numa && !_numa->Bind(_node)) {
+        _logger->warn("Failed to bind worker to NUMA node {}", _node);
+    }
+
     // Process connection events
     //
     // Do not forget to use EPOLLEXCLUSIVE flag when register socket
@@ -98,8 +109,9 @@ void Worker::OnRun() {
             } else if (current_event.events & EPOLLRDHUP) {
                 pconn->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Depends on what connection wants... Connection moved from another node has input
+                // already read and is woken up by EPOLLOUT
+                if ((current_event.events & EPOLLIN) || pconn->_has_input()) {
                     pconn->DoRead();
                 }
                 if (current_event.events & EPOLLOUT) {
@@ -107,8 +119,22 @@ void Worker::OnRun() {
                 }
             }
 
+            // Move connection to the node it asked for
+            if (pconn->isAlive() && pconn->_migrate_to >= 0) {
+                int target = _epoll_fds[pconn->_migrate_to];
+                pconn->_node = pconn->_migrate_to;
+                pconn->_migrate_to = -1;
+                pconn->_event.events = Connection::mask_read_write;
+                _stats->migrations.Add();
+                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event) ||
+                    epoll_ctl(target, EPOLL_CTL_ADD, pconn->_socket, &pconn->_event)) {
+                    pconn->OnError();
+                    _conns.erase(pconn);
+                    delete pconn;
+                }
+            }
             // Rearm connection
-            if (pconn->isAlive()) {
+            else if (pconn->isAlive()) {
                 pconn->_event.events |= EPOLLONESHOT;
                 if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
                     pconn->OnError();
@@ -121,6 +147,7 @@ void Worker::OnRun() {
                 if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
                     std::cerr << "Failed to delete connection!" << std::endl;
                 }
+                _stats->connections_closed.Add();
                 _conns.erase(pconn);
                 delete pconn;
             }
@@ -5,8 +5,10 @@
 #include <memory>
 #include <set>
 #include <thread>
+#include <vector>
 
 #include "Connection.h"
+#include <afina/concurrency/Numa.h>
 
 namespace spdlog {
 class logger;
@@ -31,7 +33,8 @@ namespace MTnonblock {
 class Worker {
 public:
     Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,
-           std::set<Connection *> &_conns);
+           std::set<Connection *> &_conns, Statistics *stats,
+           std::shared_ptr<const Concurrency::Topology> numa = nullptr);
     ~Worker();
 
     Worker(Worker &&);
@@ -41,8 +44,12 @@ public:
      * Spaws new background thread that is doing epoll on the given server
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
+     *
+     * @param epoll_fds epoll of every NUMA node, worker waits on the one of its node and moves
+     * connections to others when they ask for
+     * @param node index of the node worker belongs to
      */
-    void Start(int epoll_fd);
+    void Start(const std::vector<int> &epoll_fds, std::size_t node);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -86,7 +93,17 @@ private:
     // EPOLL descriptor using for events processing
     int _epoll_fd;
 
+    // EPOLL descriptors of all nodes and index of the own one
+    std::vector<int> _epoll_fds;
+    std::size_t _node;
+
+    // Nodes to bind thread to, nullptr if NUMA mode is off
+    std::shared_ptr<const Concurrency::Topology> _numa;
+
     std::set<Connection *> &_conns;
+
+    // Server wide counters
+    Statistics *_stats;
 };
 
 } // namespace MTnonblock
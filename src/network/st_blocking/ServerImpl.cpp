@@ -18,7 +18,10 @@
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
+#include <afina/execute/Batch.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Metrics.h>
+#include <afina/execute/SlowLog.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
@@ -129,6 +132,7 @@ void ServerImpl::OnRun() {
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
+    Execute::RequestTrace trace;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
@@ -139,6 +143,7 @@ void ServerImpl::OnRun() {
         if ((client_socket = accept(_server_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
             continue;
         }
+        Execute::Metrics::Default().ConnectionOpened();
 
         // Got new connection
         if (_logger->should_log(spdlog::level::debug)) {
@@ -166,9 +171,10 @@ void ServerImpl::OnRun() {
         // - execute each command
         // - send response
         try {
+            ConnectionGuard guard(*pMemory);
             int readed_bytes = -1;
             char client_buffer[4096];
-            while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+            while ((readed_bytes = trace.Read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
 
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
@@ -180,15 +186,20 @@ void ServerImpl::OnRun() {
                     // There is no command yet
                     if (!command_to_execute) {
                         std::size_t parsed = 0;
+                        trace.Begin();
+                        Execute::TracePhase parse_phase(trace, Execute::RequestTrace::Phase::Parse);
                         if (parser.Parse(client_buffer, readed_bytes, parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
                             command_to_execute = parser.Build(arg_remains);
                             if (arg_remains > 0) {
+                                guard.Item(arg_remains);
+                                guard.Use(arg_remains);
                                 arg_remains += 2;
                             }
                         }
+                        guard.Line(parser.Consumed());
 
                         // Parsed might fails to consume any bytes from input stream. In real life that could happens,
                         // for example, because we are working with UTF-16 chars and only 1 byte left in stream
@@ -217,18 +228,32 @@ void ServerImpl::OnRun() {
                         _logger->debug("Start command execution");
 
                         std::string result;
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
+                        {
+                            Execute::CommandTimer timer(parser.Name());
+                            Execute::TracePhase execute_phase(trace, Execute::RequestTrace::Phase::Execute);
+                            command_to_execute->Execute(*pStorage, argument_for_command, result);
+                        }
+                        trace.Describe(parser.Name(), *command_to_execute, argument_for_command.size(), result.size());
 
                         // Send response
                         result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
+                        {
+                            Execute::TracePhase write_phase(trace, Execute::RequestTrace::Phase::Write);
+                            if (send(client_socket, result.data(), result.size(), 0) <= 0) {
+                                throw std::runtime_error("Failed to send response");
+                            }
                         }
+                        trace.End();
 
                         // Prepare for the next command
                         command_to_execute.reset();
                         argument_for_command.resize(0);
+                        if (argument_for_command.capacity() > Execute::Batch::kKeepArgument) {
+                            // Guard is told only small buffer stays with the connection
+                            std::string().swap(argument_for_command);
+                        }
                         parser.Reset();
+                        guard.Use(argument_for_command.capacity());
                     }
                 } // while (readed_bytes)
             }
@@ -238,17 +263,22 @@ void ServerImpl::OnRun() {
             } else {
                 throw std::runtime_error(std::string(strerror(errno)));
             }
+        } catch (LimitExceeded &ex) {
+            _logger->warn("Close connection on descriptor {}: {}", client_socket, ex.what());
+            ReplyLimitExceeded(client_socket, ex);
         } catch (std::runtime_error &ex) {
             _logger->error("Failed to process connection on descriptor {}: {}", client_socket, ex.what());
         }
 
         // We are done with this connection
         close(client_socket);
+        Execute::Metrics::Default().ConnectionClosed();
 
         // Prepare for the next command: just in case if connection was closed in the middle of executing something
         command_to_execute.reset();
-        argument_for_command.resize(0);
+        std::string().swap(argument_for_command);
         parser.Reset();
+        trace.Reset();
     }
 
     // Cleanup on exit...
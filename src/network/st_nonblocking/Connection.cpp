@@ -5,6 +5,9 @@
 
 #include <unistd.h>
 
+#include <afina/concurrency/Tsc.h>
+#include <afina/execute/Batch.h>
+
 namespace Afina {
 namespace Network {
 namespace STnonblock {
@@ -15,7 +18,7 @@ void Connection::Start(std::shared_ptr<spdlog::logger> logger) {
     // _event.data.fd = _socket;
     _event.data.ptr = this;
     _logger = logger;
-    _answers.clear();
+    _output.Clear();
     command_to_execute = nullptr;
     argument_for_command.clear();
 }
@@ -36,99 +39,129 @@ void Connection::OnClose() {
 void Connection::DoRead() {
     try {
         int readed_bytes_new = -1;
-        while ((readed_bytes_new = read(_socket, client_buffer + readed_bytes, sizeof(client_buffer) - readed_bytes)) >
-               0) {
+        while (!_paused() && (readed_bytes_new = _trace.Read(_socket, client_buffer + readed_bytes,
+                                                             sizeof(client_buffer) - readed_bytes)) > 0) {
             readed_bytes += readed_bytes_new;
-            while (readed_bytes > 0) {
-                // There is no command yet
-                if (!command_to_execute) {
-                    std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, readed_bytes, parsed)) {
-                        // There is no command to be launched, continue to parse input stream
-                        // Here we are, current chunk finished some command, process it
-                        command_to_execute = parser.Build(arg_remains);
-                        if (arg_remains > 0) {
-                            arg_remains += 2;
-                        }
-                    }
-
-                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
-                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
-                    if (parsed == 0) {
-                        break;
-                    } else {
-                        std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
-                    }
-                }
-
-                // There is command, but we still wait for argument to arrive...
-                if (command_to_execute && arg_remains > 0) {
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+            _process();
+        }
+    } catch (LimitExceeded &ex) {
+        _logger->warn("Close connection on descriptor {} : {}", _socket, ex.what());
+        ReplyLimitExceeded(_socket, ex);
+        OnError();
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
+    }
+    _event.events = _mask();
+}
 
-                    std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
-                    arg_remains -= to_read;
-                    readed_bytes -= to_read;
+void Connection::_process() {
+    while (readed_bytes > 0 && !_paused()) {
+        // There is no command yet
+        if (!command_to_execute) {
+            std::size_t parsed = 0;
+            _trace.Begin();
+            Execute::TracePhase parse_phase(_trace, Execute::RequestTrace::Phase::Parse);
+            if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                // There is no command to be launched, continue to parse input stream
+                // Here we are, current chunk finished some command, process it
+                command_to_execute = parser.Build(arg_remains);
+                if (arg_remains > 0) {
+                    _guard.Item(arg_remains);
+                    _guard.Use(arg_remains + _output.Size());
+                    arg_remains += 2;
                 }
+            }
+            _guard.Line(parser.Consumed());
+
+            // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+            // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+            if (parsed == 0) {
+                break;
+            } else {
+                std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
+                readed_bytes -= parsed;
+            }
+        }
 
-                // There is command & argument - RUN!
-                if (command_to_execute && arg_remains == 0) {
-                    std::string result;
-                    command_to_execute->Execute(*pStorage, argument_for_command, result);
-                    result += "\r\n";
-
-                    if (_answers.size() == 0) {
-                        _event.events = mask_read_write;
-                    }
-                    // Save response
-                    _answers.push_back(result);
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            // There is some parsed command, and now we are reading argument
+            std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
+            argument_for_command.append(client_buffer, to_read);
 
+            std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+            arg_remains -= to_read;
+            readed_bytes -= to_read;
+        }
 
-                    // Prepare for the next command
-                    command_to_execute.reset();
-                    argument_for_command.resize(0);
-                    parser.Reset();
-                }
-            } // while (readed_bytes)
+        // There is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            std::string result;
+            {
+                Execute::CommandTimer timer(parser.Name());
+                Execute::TracePhase execute_phase(_trace, Execute::RequestTrace::Phase::Execute);
+                command_to_execute->Execute(*pStorage, argument_for_command, result);
+            }
+            _trace.Describe(parser.Name(), *command_to_execute, argument_for_command.size(), result.size());
+            result += "\r\n";
+
+            // Save response
+            _output.Append(result);
+            _traces.Queued(_trace, result.size());
+
+            // Prepare for the next command
+            command_to_execute.reset();
+            argument_for_command.resize(0);
+            if (argument_for_command.capacity() > Execute::Batch::kKeepArgument) {
+                // Guard is told only small buffer stays with the connection
+                std::string().swap(argument_for_command);
+            }
+            parser.Reset();
+            _guard.Use(_output.Size() + argument_for_command.capacity());
         }
-    } catch (std::runtime_error &ex) {
-        _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
     }
 }
 
-void Connection::DoWrite() {
-    if (_answers.empty()) {
-        return;
+int Connection::_mask() const {
+    if (_output.Empty()) {
+        return mask_read;
     }
+    return _paused() ? mask_write : mask_read_write;
+}
 
-    struct iovec iovecs[_answers.size()];
-    for (int i = 0; i < _answers.size(); i++) {
-        iovecs[i].iov_len = _answers[i].size();
-        iovecs[i].iov_base = &(_answers[i][0]);
+void Connection::DoWrite() {
+    if (_output.Empty()) {
+        _event.events = _mask();
+        return;
     }
 
-    iovecs[0].iov_base = static_cast<char *>(iovecs[0].iov_base) + _position;
-    assert(iovecs[0].iov_len > _position);
-    iovecs[0].iov_len -= _position;
+    struct iovec iovecs[kMaxIovecs];
+    int count = _output.Prepare(iovecs, kMaxIovecs);
 
-    int written;
-    if ((written = writev(_socket, iovecs, _answers.size())) <= 0) {
+    uint64_t started = Concurrency::Tsc::Now();
+    ssize_t written = writev(_socket, iovecs, count);
+    if (written <= 0) {
         OnError();
+        return;
     }
-    _position += written;
-
-    int i = 0;
-    for (; i < _answers.size(); ++i) {
-        assert(_position >= iovecs[i].iov_len);
-        _position -= iovecs[i].iov_len;
-    }
-
-    _answers.erase(_answers.begin(), _answers.begin() + i);
-    if (_answers.empty()) {
-        _event.events = mask_read;
+    _traces.Written(written, Concurrency::Tsc::Now() - started);
+
+    const bool paused = _paused();
+    _output.Consume(written);
+    _guard.Use(_output.Size() + argument_for_command.capacity());
+    if (paused && !_paused()) {
+        // Input read before the pause
+        try {
+            _process();
+        } catch (LimitExceeded &ex) {
+            _logger->warn("Close connection on descriptor {} : {}", _socket, ex.what());
+            ReplyLimitExceeded(_socket, ex);
+            OnError();
+        } catch (std::runtime_error &ex) {
+            _logger->error("Failed to process connection on descriptor {} : {}", _socket, ex.what());
+        }
     }
+    _event.events = _mask();
 }
 
 } // namespace STnonblock
@@ -12,6 +12,10 @@
 #include "protocol/Parser.h"
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Metrics.h>
+#include <afina/execute/SlowLog.h>
+#include <afina/network/Limits.h>
+#include <afina/network/OutputBuffer.h>
 #include <spdlog/logger.h>
 #include <sys/epoll.h>
 
@@ -25,10 +29,13 @@ namespace STnonblock {
 
 class Connection {
 public:
-    Connection(int s, std::shared_ptr<Afina::Storage> ps) : _socket(s), pStorage(ps) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, ConnectionMemory &memory)
+        : _socket(s), pStorage(ps), _guard(memory) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _isAlive = true;
+        Execute::Metrics::Default().ConnectionOpened();
     }
+    ~Connection() { Execute::Metrics::Default().ConnectionClosed(); }
 
     inline bool isAlive() const { return _isAlive; }
 
@@ -43,8 +50,22 @@ protected:
 private:
     friend class ServerImpl;
 
+    // Parses and executes commands from input already in the buffer
+    void _process();
+
+    // Whether client reads responses slower than it sends requests: neither socket nor input read
+    // already are touched until output drains below the limit
+    bool _paused() const { return _guard.Paused(_output.Size()); }
+
+    // Events to wait for given the state of buffers
+    int _mask() const;
+
     static const int mask_read = EPOLLIN | EPOLLRDHUP | EPOLLERR;
     static const int mask_read_write = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLOUT;
+    static const int mask_write = EPOLLRDHUP | EPOLLERR | EPOLLOUT;
+
+    // Max number of chunks sent by one writev
+    static constexpr int kMaxIovecs = 64;
 
     std::shared_ptr<spdlog::logger> _logger;
     std::shared_ptr<Afina::Storage> pStorage;
@@ -53,17 +74,23 @@ private:
     bool _isAlive;
     struct epoll_event _event;
 
+    // Limits of the client
+    ConnectionGuard _guard;
+
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
 
+    // Request being read and requests waiting for their responses to be written
+    Execute::RequestTrace _trace;
+    Execute::PendingTraces _traces;
+
     int readed_bytes = 0;
     char client_buffer[4096];
-    // char write_buffer[4096];
 
-    std::vector<std::string> _answers;
-    int _position = 0;
+    // Responses not written yet
+    OutputBuffer _output;
 };
 
 } // namespace STnonblock
@@ -208,7 +208,15 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         }
 
         // Register the new FD to be monitored by epoll.
-        Connection *pc = new Connection(infd, pStorage);
+        Connection *pc;
+        try {
+            pc = new Connection(infd, pStorage, *pMemory);
+        } catch (LimitExceeded &ex) {
+            _logger->warn("Reject connection on descriptor {} : {}", infd, ex.what());
+            ReplyLimitExceeded(infd, ex);
+            close(infd);
+            continue;
+        }
         _conns.insert(pc);
         if (pc == nullptr) {
             throw std::runtime_error("Failed to allocate connection");
@@ -32,6 +32,9 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                     state = State::spKey;
                 } else if (name == "get" || name == "gets") {
                     state = State::sgKey;
+                } else if (name == "stats" && c == ' ') {
+                    // Statistics group goes as a key
+                    state = State::sgKey;
                 } else if (name == "stats") {
                     state = State::sLF;
                     continue;
@@ -158,6 +161,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     }
 
     parsed += pos;
+    consumed += pos;
     return parse_complete;
 }
 
@@ -177,7 +181,7 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
     } else if (name == "get") {
         return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
     } else if (name == "stats") {
-        return std::unique_ptr<Execute::Command>(new Execute::Stats());
+        return std::unique_ptr<Execute::Command>(new Execute::Stats(keys));
     } else {
         throw std::runtime_error("Unsupported command");
     }
@@ -190,6 +194,7 @@ void Parser::Reset() {
     keys.clear();
     curKey.clear();
     parse_complete = false;
+    consumed = 0;
     flags = 0;
     bytes = 0;
     exprtime = 0;
@@ -55,6 +55,11 @@ public:
 
     inline const std::string &Name() const { return name; }
 
+    /**
+     * Number of bytes of the current command line consumed since the last Reset
+     */
+    inline std::size_t Consumed() const { return consumed; }
+
 private:
     /**
      * State of the command parser. Prefixes are:
@@ -91,6 +96,9 @@ private:
     bool negative;
     std::string curKey;
     bool parse_complete;
+
+    // Length of the command line parsed so far
+    std::size_t consumed;
 };
 
 } // namespace Protocol
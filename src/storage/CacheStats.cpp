@@ -0,0 +1,58 @@
+#include "CacheStats.h"
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Upper bounds of idle time classes in seconds and their names
+const uint64_t kAgeBounds[CacheStats::kAges - 1] = {1, 10, 60, 600, 3600, 86400};
+const char *const kAgeNames[CacheStats::kAges] = {"1s", "10s", "1m", "10m", "1h", "1d", "inf"};
+
+// Size classes grow by 4x starting from 64 bytes
+const std::size_t kFirstClass = 64;
+
+} // namespace
+
+constexpr std::size_t CacheStats::kClasses;
+constexpr std::size_t CacheStats::kAges;
+
+// See CacheStats.h
+void CacheStats::Evicted(uint64_t touched) {
+    _evictions++;
+    const uint64_t idle = Concurrency::Tsc::ToNanos(Concurrency::Tsc::Now() - touched) / 1000000000;
+    std::size_t age = 0;
+    while (age < kAges - 1 && idle >= kAgeBounds[age]) {
+        age++;
+    }
+    _ages[age]++;
+}
+
+// See CacheStats.h
+std::size_t CacheStats::ClassOf(std::size_t payload) {
+    std::size_t c = 0;
+    for (std::size_t bound = kFirstClass; c < kClasses - 1 && payload > bound; bound *= 4) {
+        c++;
+    }
+    return c;
+}
+
+// See CacheStats.h
+void CacheStats::Report(std::vector<std::pair<std::string, std::string>> &stats) const {
+    stats.emplace_back("lookup_hits", std::to_string(_hits));
+    stats.emplace_back("lookup_misses", std::to_string(_misses));
+    stats.emplace_back("evictions", std::to_string(_evictions));
+    for (std::size_t i = 0; i < kAges; i++) {
+        stats.emplace_back(std::string("evicted_idle_") + kAgeNames[i], std::to_string(_ages[i]));
+    }
+
+    std::size_t bound = kFirstClass;
+    for (std::size_t i = 0; i < kClasses; i++, bound *= 4) {
+        const std::string name = "class_" + (i + 1 < kClasses ? std::to_string(bound) : std::string("inf"));
+        stats.emplace_back(name + "_items", std::to_string(_items[i]));
+        stats.emplace_back(name + "_bytes", std::to_string(_bytes[i]));
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,78 @@
+#ifndef AFINA_STORAGE_CACHE_STATS_H
+#define AFINA_STORAGE_CACHE_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/concurrency/Tsc.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Cache efficiency counters
+ * Lookup hits and misses, evictions along with how long evicted entries stayed unused, and number
+ * and payload bytes of entries in each size class, to see whether memory is large enough and
+ * eviction policy throws away the right entries.
+ *
+ * Owned by the storage and updated under its lock, so counters are plain integers. Idle time is
+ * measured in TSC ticks taken when entry is touched. Every instance reports the same names in the
+ * same order, so ShardedStorage sums them like other stats.
+ */
+class CacheStats {
+public:
+    // Size classes by key plus value bytes: up to 64, 256, ... 1M, the last one is for the rest
+    static constexpr std::size_t kClasses = 9;
+
+    // Idle time of evicted entries: up to 1s, 10s, 1m, 10m, 1h, 1d, the last one is for the rest
+    static constexpr std::size_t kAges = 7;
+
+    CacheStats() : _hits(0), _misses(0), _evictions(0), _ages(), _items(), _bytes() {}
+
+    void Hit() { _hits++; }
+    void Miss() { _misses++; }
+
+    /**
+     * Entry last touched at the given TSC time is evicted
+     */
+    void Evicted(uint64_t touched);
+
+    /**
+     * Entry with the given key and value sizes is added or removed
+     */
+    void Added(std::size_t payload) {
+        std::size_t c = ClassOf(payload);
+        _items[c]++;
+        _bytes[c] += payload;
+    }
+    void Removed(std::size_t payload) {
+        std::size_t c = ClassOf(payload);
+        _items[c]--;
+        _bytes[c] -= payload;
+    }
+
+    uint64_t Evictions() const { return _evictions; }
+
+    /**
+     * Appends all counters as name/value pairs
+     */
+    void Report(std::vector<std::pair<std::string, std::string>> &stats) const;
+
+    static std::size_t ClassOf(std::size_t payload);
+
+private:
+    uint64_t _hits;
+    uint64_t _misses;
+    uint64_t _evictions;
+    uint64_t _ages[kAges];
+    uint64_t _items[kClasses];
+    uint64_t _bytes[kClasses];
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CACHE_STATS_H
@@ -0,0 +1,54 @@
+#ifndef AFINA_STORAGE_ENCODING_H
+#define AFINA_STORAGE_ENCODING_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Backend {
+
+// Primitives shared by the on disk formats: snapshot, journal and mapped storage
+
+const uint64_t kFnvOffset = 14695981039346656037ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+// FNV-1a, stable between builds unlike std::hash
+inline uint64_t fnv1a(uint64_t hash, const void *data, std::size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+// Max bytes put_varint could take
+const std::size_t kMaxVarint = 10;
+
+// Appends LEB128 encoding of the value, returns number of bytes used
+inline std::size_t put_varint(char *out, uint64_t value) {
+    std::size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<char>(value);
+    return n;
+}
+
+// Decodes LEB128 value at pos, false if it runs out of [pos, end)
+inline bool get_varint(const char *&pos, const char *end, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(*pos++);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ENCODING_H
@@ -0,0 +1,162 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <exception>
+#include <string>
+
+#include <afina/concurrency/FlatCombine.h>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU thread safe version
+ * Operations are published via flat combining, so under contention a single thread applies
+ * a batch of LRU updates instead of each thread taking global lock in turn
+ */
+class FlatCombineLRU : public SimpleLRU {
+public:
+    FlatCombineLRU(size_t max_size = 1024, size_t expected_items = 0, Allocator::PoolResource *pools = nullptr)
+        : SimpleLRU(max_size, expected_items, pools), _fc([this](Operation **ops, std::size_t count) { _apply(ops, count); }) {}
+    ~FlatCombineLRU() {}
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        Operation op(Operation::kPut, key, &value, nullptr);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        Operation op(Operation::kPutIfAbsent, key, &value, nullptr);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        Operation op(Operation::kSet, key, &value, nullptr);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        Operation op(Operation::kDelete, key, nullptr, nullptr);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        Operation op(Operation::kGet, key, nullptr, &value);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override {
+        static const std::string no_key;
+        Operation op(Operation::kStats, no_key, nullptr, nullptr);
+        op.stats = &stats;
+        _execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool Restore(const std::string &key, const std::string &value) override {
+        Operation op(Operation::kRestore, key, &value, nullptr);
+        _execute(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool CanQuiesce() const override { return true; }
+
+    // see SimpleLRU.h, function runs on the combiner thread
+    void Quiesce(const std::function<void()> &f) override {
+        static const std::string no_key;
+        Operation op(Operation::kQuiesce, no_key, nullptr, nullptr);
+        op.fn = &f;
+        _execute(op);
+    }
+
+private:
+    // Storage request published into combining slot
+    struct Operation {
+        enum Type { kPut, kPutIfAbsent, kSet, kDelete, kGet, kStats, kRestore, kQuiesce };
+
+        Operation(Type t, const std::string &k, const std::string *v, std::string *o)
+            : type(t), key(k), value(v), out(o), stats(nullptr), fn(nullptr), result(false) {}
+
+        const Type type;
+        const std::string &key;
+        const std::string *value;
+        std::string *out;
+        std::vector<std::pair<std::string, std::string>> *stats;
+        const std::function<void()> *fn;
+        bool result;
+
+        // Thrown while the operation was applied, owner rethrows it
+        std::exception_ptr error;
+    };
+
+    // Publishes operation and rethrows its own exception
+    void _execute(Operation &op) {
+        _fc.Execute(op);
+        if (op.error) {
+            std::rethrow_exception(op.error);
+        }
+    }
+
+    // Runs on the combiner thread
+    void _apply(Operation **ops, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            Operation &op = *ops[i];
+            try {
+                _apply(op);
+            } catch (...) {
+                op.error = std::current_exception();
+            }
+        }
+    }
+
+    // Applies one operation to the underlying SimpleLRU
+    void _apply(Operation &op) {
+        switch (op.type) {
+        case Operation::kPut:
+            op.result = SimpleLRU::Put(op.key, *op.value);
+            break;
+        case Operation::kPutIfAbsent:
+            op.result = SimpleLRU::PutIfAbsent(op.key, *op.value);
+            break;
+        case Operation::kSet:
+            op.result = SimpleLRU::Set(op.key, *op.value);
+            break;
+        case Operation::kDelete:
+            op.result = SimpleLRU::Delete(op.key);
+            break;
+        case Operation::kGet:
+            op.result = SimpleLRU::Get(op.key, *op.out);
+            break;
+        case Operation::kStats:
+            SimpleLRU::Stats(*op.stats);
+            break;
+        case Operation::kRestore:
+            op.result = SimpleLRU::Restore(op.key, *op.value);
+            break;
+        case Operation::kQuiesce:
+            (*op.fn)();
+            break;
+        }
+    }
+
+    Concurrency::FlatCombine<Operation> _fc;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
@@ -0,0 +1,214 @@
+#include "HotCache.h"
+
+#include <functional>
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t HotCache::kSlots;
+constexpr std::size_t HotCache::kStripes;
+constexpr std::size_t HotCache::kCounters;
+constexpr uint8_t HotCache::kAdmit;
+constexpr uint32_t HotCache::kAging;
+constexpr uint32_t HotCache::kRefresh;
+
+HotCache::HotCache(std::shared_ptr<Afina::Storage> storage, std::size_t max_value)
+    : _storage(std::move(storage)), _max_value(max_value), _versions(new std::atomic<uint64_t>[kStripes]()) {}
+
+// See HotCache.h
+bool HotCache::Put(const std::string &key, const std::string &value) {
+    bool result = _storage->Put(key, value);
+    _bump(key);
+    return result;
+}
+
+// See HotCache.h
+bool HotCache::PutIfAbsent(const std::string &key, const std::string &value) {
+    bool result = _storage->PutIfAbsent(key, value);
+    _bump(key);
+    return result;
+}
+
+// See HotCache.h
+bool HotCache::Set(const std::string &key, const std::string &value) {
+    bool result = _storage->Set(key, value);
+    _bump(key);
+    return result;
+}
+
+// See HotCache.h
+bool HotCache::Delete(const std::string &key) {
+    bool result = _storage->Delete(key);
+    _bump(key);
+    return result;
+}
+
+// See HotCache.h
+bool HotCache::Restore(const std::string &key, const std::string &value) {
+    bool result = _storage->Restore(key, value);
+    _bump(key);
+    return result;
+}
+
+// See HotCache.h
+bool HotCache::Get(const std::string &key, std::string &value) {
+    const std::size_t hash = _hash(key);
+    std::atomic<uint64_t> &version = _version(hash);
+    Cell &cell = _cells.local();
+
+    bool admitted;
+    {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        if (_hit(cell, key, hash, value)) {
+            return true;
+        }
+        admitted = _admit(cell, hash);
+    }
+
+    // Version is taken before the read: write completed in between makes the copy stale right away
+    const uint64_t seen = version.load(std::memory_order_acquire);
+    if (!_storage->Get(key, value)) {
+        return false;
+    }
+    if (admitted && value.size() <= _max_value) {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        _fill(cell, key, hash, seen, value);
+        _fills.Add();
+    }
+    return true;
+}
+
+// See HotCache.h
+void HotCache::GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                       std::vector<bool> &found) {
+    // Misses of the call, reused by the next ones on the thread
+    struct Misses {
+        std::vector<std::size_t> index;
+        std::vector<std::size_t> hash;
+        std::vector<const std::string *> keys;
+        std::vector<std::string> values;
+        std::vector<bool> found;
+        std::vector<uint64_t> seen;
+        std::vector<bool> admitted;
+    };
+    static thread_local Misses misses;
+    misses.index.clear();
+    misses.hash.clear();
+    misses.keys.clear();
+    misses.seen.clear();
+    misses.admitted.clear();
+
+    values.resize(keys.size());
+    found.assign(keys.size(), false);
+    Cell &cell = _cells.local();
+    {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            const std::size_t hash = _hash(*keys[i]);
+            if (_hit(cell, *keys[i], hash, values[i])) {
+                found[i] = true;
+                continue;
+            }
+            misses.index.push_back(i);
+            misses.hash.push_back(hash);
+            misses.keys.push_back(keys[i]);
+            misses.admitted.push_back(_admit(cell, hash));
+        }
+    }
+    if (misses.keys.empty()) {
+        return;
+    }
+
+    // Versions are taken before the read, as in Get
+    for (std::size_t hash : misses.hash) {
+        misses.seen.push_back(_version(hash).load(std::memory_order_acquire));
+    }
+    _storage->GetMany(misses.keys, misses.values, misses.found);
+
+    std::unique_lock<std::mutex> lock(cell.mutex, std::defer_lock);
+    for (std::size_t j = 0; j < misses.keys.size(); j++) {
+        const std::size_t i = misses.index[j];
+        if (!misses.found[j]) {
+            continue;
+        }
+        values[i].swap(misses.values[j]);
+        found[i] = true;
+        if (misses.admitted[j] && values[i].size() <= _max_value) {
+            if (!lock.owns_lock()) {
+                lock.lock();
+            }
+            _fill(cell, *keys[i], misses.hash[j], misses.seen[j], values[i]);
+            _fills.Add();
+        }
+    }
+}
+
+// See HotCache.h
+void HotCache::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    _storage->Stats(stats);
+    stats.emplace_back("hot_cache_hits", std::to_string(_hits.Get()));
+    stats.emplace_back("hot_cache_fills", std::to_string(_fills.Get()));
+    stats.emplace_back("hot_cache_invalidations", std::to_string(_invalidations.Get()));
+}
+
+bool HotCache::_hit(Cell &cell, const std::string &key, std::size_t hash, std::string &value) {
+    for (auto &entry : cell.entries) {
+        if (!entry.used || entry.hash != hash || entry.key != key) {
+            continue;
+        }
+        if (entry.version != _version(hash).load(std::memory_order_acquire)) {
+            _invalidations.Add();
+        } else if (++entry.hits < kRefresh) {
+            value = entry.value;
+            _hits.Add();
+            return true;
+        }
+        entry.used = false;
+        break;
+    }
+    return false;
+}
+
+bool HotCache::_admit(Cell &cell, std::size_t hash) {
+    if (++cell.reads >= kAging) {
+        // Forget old popularity, so keys which cooled down give way to new hot ones
+        cell.reads = 0;
+        for (auto &c : cell.counters) {
+            c /= 2;
+        }
+    }
+
+    uint8_t &counter = cell.counters[hash % kCounters];
+    if (counter < UINT8_MAX) {
+        counter++;
+    }
+    return counter >= kAdmit;
+}
+
+void HotCache::_fill(Cell &cell, const std::string &key, std::size_t hash, uint64_t version,
+                     const std::string &value) {
+    // Free slot goes first, then the least frequent entry
+    auto rank = [&cell](const Entry &entry) { return entry.used ? cell.counters[entry.hash % kCounters] + 1 : 0; };
+
+    Entry *target = &cell.entries[0];
+    for (auto &entry : cell.entries) {
+        if (entry.used && entry.hash == hash && entry.key == key) {
+            // Filled by another thread on the same CPU meanwhile
+            target = &entry;
+            break;
+        }
+        if (rank(entry) < rank(*target)) {
+            target = &entry;
+        }
+    }
+
+    target->key = key;
+    target->value = value;
+    target->hash = hash;
+    target->version = version;
+    target->hits = 0;
+    target->used = true;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,138 @@
+#ifndef AFINA_STORAGE_HOT_CACHE_H
+#define AFINA_STORAGE_HOT_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Per CPU read cache of hot keys
+ * Every CPU keeps copies of a few most read keys, so reads of a key taking large share of traffic
+ * don't all go to the lock of the one shard holding it.
+ *
+ * Key gets cached once it was read kAdmit times on the CPU within the aging window, counted in a
+ * small per CPU frequency table which is halved every kAging reads. When there is no free slot
+ * the entry with the lowest frequency gives way.
+ *
+ * Each key maps to one of kStripes versions bumped on every write. Cached copy remembers version
+ * seen before it was read from the storage and is valid only while version stays the same, so
+ * read never returns value older than the last completed write. Copy is also re-read every
+ * kRefresh hits to keep recency in the underlying LRU and drop keys it has evicted.
+ */
+class HotCache : public Afina::Storage {
+public:
+    static constexpr std::size_t kSlots = 8;
+    static constexpr std::size_t kStripes = 1024;
+    static constexpr std::size_t kCounters = 256;
+    static constexpr uint8_t kAdmit = 16;
+    static constexpr uint32_t kAging = 4096;
+    static constexpr uint32_t kRefresh = 1024;
+
+    /**
+     * @param storage storage to cache reads of
+     * @param max_value larger values are never cached
+     */
+    HotCache(std::shared_ptr<Afina::Storage> storage, std::size_t max_value = 4096);
+    ~HotCache() {}
+
+    // Implements Afina::Storage interface
+    void Start() override { _storage->Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _storage->Stop(); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface, cached keys are served here and only misses go to the storage
+    void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                 std::vector<bool> &found) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    int NodeOf(const std::string &key) const override { return _storage->NodeOf(key); }
+
+    // Implements Afina::Storage interface
+    void ForEach(const Visitor &visitor) override { _storage->ForEach(visitor); }
+
+    // Implements Afina::Storage interface
+    void Quiesce(const std::function<void()> &f) override { _storage->Quiesce(f); }
+
+    // Implements Afina::Storage interface
+    bool CanQuiesce() const override { return _storage->CanQuiesce(); }
+
+    // Implements Afina::Storage interface
+    bool Restore(const std::string &key, const std::string &value) override;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string value;
+        std::size_t hash = 0;
+        uint64_t version = 0;
+        uint32_t hits = 0;
+        bool used = false;
+    };
+
+    // Cache of one CPU. Lock is taken by threads running on that CPU, so it is almost never contended
+    struct Cell {
+        std::mutex mutex;
+        Entry entries[kSlots];
+        uint8_t counters[kCounters] = {};
+        uint32_t reads = 0;
+    };
+
+    static std::size_t _hash(const std::string &key) { return std::hash<std::string>()(key); }
+
+    std::atomic<uint64_t> &_version(std::size_t hash) { return _versions[hash % kStripes]; }
+
+    // Invalidates cached copies of the key everywhere
+    void _bump(const std::string &key) { _version(_hash(key)).fetch_add(1, std::memory_order_release); }
+
+    // Looks key up in the cell, called with its lock held. Stale or due for refresh copy is dropped
+    bool _hit(Cell &cell, const std::string &key, std::size_t hash, std::string &value);
+
+    // Counts read of the key, true if it is frequent enough to be cached
+    bool _admit(Cell &cell, std::size_t hash);
+
+    // Places value into the cell in place of the least frequent entry
+    void _fill(Cell &cell, const std::string &key, std::size_t hash, uint64_t version, const std::string &value);
+
+    std::shared_ptr<Afina::Storage> _storage;
+    const std::size_t _max_value;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> _versions;
+    Concurrency::CoreLocal<Cell> _cells;
+
+    Concurrency::CoreCounter _hits;
+    Concurrency::CoreCounter _fills;
+    Concurrency::CoreCounter _invalidations;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HOT_CACHE_H
@@ -0,0 +1,315 @@
+#include "Journal.h"
+#include "Encoding.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <spdlog/logger.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+const char kMagic[] = "AFWAL001";
+const std::size_t kMagicSize = sizeof(kMagic) - 1;
+
+// Appenders block once that much is waiting for the writer
+const std::size_t kMaxPending = 64 << 20;
+
+// Writes the whole buffer, retrying short writes
+bool write_all(int fd, const char *data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Directory part of the path and the rest
+std::pair<std::string, std::string> split_path(const std::string &path) {
+    std::size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        return {".", path};
+    }
+    return {slash == 0 ? "/" : path.substr(0, slash), path.substr(slash + 1)};
+}
+
+} // namespace
+
+Journal::Journal(const std::string &path)
+    : _path(path), _appended(0), _done(0), _synced(0), _segment(0), _running(false), _failed(false), _batches(0), _bytes(0),
+      _fd(-1) {}
+
+Journal::~Journal() { Stop(); }
+
+// See Journal.h
+std::size_t Journal::Replay(Afina::Storage &storage) {
+    std::size_t count = 0;
+    std::string key, value;
+    for (uint64_t segment : _segments()) {
+        std::ifstream file(_segment_path(segment), std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        const std::string data = content.str();
+        if (data.compare(0, kMagicSize, kMagic) != 0) {
+            continue;
+        }
+
+        const char *pos = data.data() + kMagicSize;
+        const char *end = data.data() + data.size();
+        while (pos < end) {
+            const char *record = pos++;
+            uint64_t key_size, value_size;
+            uint32_t checksum;
+            if (!get_varint(pos, end, key_size) || !get_varint(pos, end, value_size) ||
+                key_size > std::size_t(end - pos) || value_size > std::size_t(end - pos) - key_size ||
+                std::size_t(end - pos) - key_size - value_size < sizeof(checksum)) {
+                break;
+            }
+            pos += key_size + value_size;
+            std::memcpy(&checksum, pos, sizeof(checksum));
+            if (checksum != uint32_t(fnv1a(kFnvOffset, record, pos - record))) {
+                break;
+            }
+
+            key.assign(pos - value_size - key_size, key_size);
+            value.assign(pos - value_size, value_size);
+            if (*record == char(Op::Put)) {
+                storage.Put(key, value);
+            } else if (*record == char(Op::Delete)) {
+                storage.Delete(key);
+            } else {
+                break;
+            }
+            pos += sizeof(checksum);
+            count++;
+        }
+    }
+    return count;
+}
+
+// See Journal.h
+void Journal::Start() {
+    std::vector<uint64_t> segments = _segments();
+    _segment = segments.empty() ? 1 : segments.back() + 1;
+    _fd = _open(_segment);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to create journal " + _segment_path(_segment) + ": " + std::strerror(errno));
+    }
+
+    _running = true;
+    _thread = std::thread(&Journal::_writer, this);
+}
+
+// See Journal.h
+void Journal::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _has_work.notify_one();
+    _written.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+// See Journal.h
+uint64_t Journal::Append(Op op, const std::string &key, const std::string &value) {
+    char header[1 + 2 * kMaxVarint];
+    std::size_t size = 0;
+    header[size++] = char(op);
+    size += put_varint(header + size, key.size());
+    size += put_varint(header + size, value.size());
+
+    uint64_t hash = fnv1a(kFnvOffset, header, size);
+    hash = fnv1a(hash, key.data(), key.size());
+    const uint32_t checksum = fnv1a(hash, value.data(), value.size());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _written.wait(lock, [this] { return _pending.size() < kMaxPending || !_running; });
+    _pending.append(header, size);
+    _pending.append(key);
+    _pending.append(value);
+    _pending.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+    const uint64_t record = ++_appended;
+    lock.unlock();
+
+    _has_work.notify_one();
+    return record;
+}
+
+// See Journal.h
+bool Journal::Wait(uint64_t record) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _written.wait(lock, [this, record] { return _done >= record || !_running; });
+    return _synced >= record;
+}
+
+// See Journal.h
+uint64_t Journal::Rotate() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rotations.emplace_back(_pending.size(), ++_segment);
+    lock.unlock();
+
+    _has_work.notify_one();
+    return _segment;
+}
+
+// See Journal.h
+uint64_t Journal::Segment() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _segment;
+}
+
+// See Journal.h
+void Journal::Compact(uint64_t segment) {
+    for (uint64_t s : _segments()) {
+        if (s < segment) {
+            unlink(_segment_path(s).c_str());
+        }
+    }
+}
+
+// See Journal.h
+void Journal::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.emplace_back("wal_records", std::to_string(_appended));
+    stats.emplace_back("wal_batches", std::to_string(_batches));
+    stats.emplace_back("wal_bytes", std::to_string(_bytes));
+    stats.emplace_back("wal_segment", std::to_string(_segment));
+    stats.emplace_back("wal_failed", _failed ? "1" : "0");
+}
+
+std::vector<uint64_t> Journal::_segments() const {
+    std::vector<uint64_t> result;
+    auto parts = split_path(_path);
+    DIR *dir = opendir(parts.first.c_str());
+    if (dir == nullptr) {
+        return result;
+    }
+
+    const std::string prefix = parts.second + ".";
+    for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+            name.find_first_not_of("0123456789", prefix.size()) == std::string::npos) {
+            result.push_back(std::strtoull(name.c_str() + prefix.size(), nullptr, 10));
+        }
+    }
+    closedir(dir);
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::string Journal::_segment_path(uint64_t segment) const { return _path + "." + std::to_string(segment); }
+
+int Journal::_open(uint64_t segment) {
+    int fd = open(_segment_path(segment).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    if (lseek(fd, 0, SEEK_END) == 0 && (!write_all(fd, kMagic, kMagicSize) || fdatasync(fd) != 0)) {
+        close(fd);
+        return -1;
+    }
+
+    // Make the new file itself durable
+    int dir = open(split_path(_path).first.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+    return fd;
+}
+
+void Journal::_writer() {
+    std::string batch;
+    std::vector<std::pair<std::size_t, uint64_t>> rotations;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _has_work.wait(lock, [this] { return !_pending.empty() || !_rotations.empty() || !_running; });
+        if (_pending.empty() && _rotations.empty()) {
+            break;
+        }
+
+        // Everything appended so far becomes one batch
+        batch.swap(_pending);
+        rotations.swap(_rotations);
+        const uint64_t last = _appended;
+        const bool failed = _failed;
+        lock.unlock();
+        _written.notify_all();
+
+        // Nothing goes after the first failure, see Journal.h
+        bool ok = !failed;
+        const char *error = nullptr;
+        int code = 0;
+        auto write = [&](std::size_t from, std::size_t to) {
+            if (ok && !(write_all(_fd, batch.data() + from, to - from) && fdatasync(_fd) == 0)) {
+                ok = false;
+                error = "write";
+                code = errno;
+            }
+        };
+
+        std::size_t done = 0;
+        for (auto &rotation : rotations) {
+            write(done, rotation.first);
+            done = rotation.first;
+            if (_fd >= 0) {
+                close(_fd);
+            }
+            _fd = ok ? _open(rotation.second) : -1;
+            if (ok && _fd < 0) {
+                ok = false;
+                error = "open of a new segment";
+                code = errno;
+            }
+        }
+        write(done, batch.size());
+        if (!ok && !failed && _logger) {
+            _logger->error("Journal {} {} failed: {}, changes are not durable anymore", _path, error, std::strerror(code));
+        }
+
+        lock.lock();
+        _failed = !ok;
+        _done = last;
+        if (ok) {
+            _synced = last;
+        }
+        _batches++;
+        _bytes += ok ? batch.size() : 0;
+        lock.unlock();
+        _written.notify_all();
+
+        batch.clear();
+        rotations.clear();
+        lock.lock();
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,159 @@
+#ifndef AFINA_STORAGE_JOURNAL_H
+#define AFINA_STORAGE_JOURNAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <afina/Storage.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Write ahead log of storage changes
+ * Records are appended to the in memory buffer by request threads, dedicated writer thread takes
+ * everything accumulated so far, writes it out and calls fdatasync once per such batch. Threads
+ * waiting for their records are released together when the batch hits the disk (group commit).
+ *
+ * Log is split into segments <path>.<N>, each starts with "AFWAL001" followed by records:
+ *
+ * op varint(key size) varint(value size) key value u32(checksum)
+ *
+ * where op is 'P' for put and 'D' for delete, checksum is FNV-1a of the record. Every record
+ * carries the whole new state of a key, so replaying segments over any snapshot taken before the
+ * oldest of them gives the latest state. Once a snapshot is written, segments it covers could be
+ * removed, see Rotate and Compact.
+ *
+ * Once a write or fdatasync fails the journal is broken for good: segment could end with a torn
+ * record, records after which would never be replayed. Nothing is written anymore and all waiters
+ * are told their records are lost.
+ */
+class Journal {
+public:
+    enum class Op : char { Put = 'P', Delete = 'D' };
+
+    explicit Journal(const std::string &path);
+    ~Journal();
+
+    /**
+     * Applies all existing segments to the storage in order. Replay of a segment stops at the first
+     * broken record, which is the torn tail after crash. Must be called before Start
+     *
+     * @return number of records applied
+     */
+    std::size_t Replay(Afina::Storage &storage);
+
+    /**
+     * Where the writer reports failures, must be called before Start
+     */
+    void SetLogger(std::shared_ptr<spdlog::logger> logger) { _logger = std::move(logger); }
+
+    /**
+     * Opens new segment and starts writer thread, throws std::runtime_error if segment couldn't
+     * be created
+     */
+    void Start();
+
+    /**
+     * Writes out everything appended so far and stops writer thread
+     */
+    void Stop();
+
+    /**
+     * Queues record, blocks if writer is too much behind
+     *
+     * @return sequence number of the record to wait for
+     */
+    uint64_t Append(Op op, const std::string &key, const std::string &value);
+
+    /**
+     * Blocks until record is on disk
+     *
+     * @return false if log write failed or journal is stopped
+     */
+    bool Wait(uint64_t record);
+
+    /**
+     * Starts new segment: records appended from now on go there
+     *
+     * @return number of the new segment
+     */
+    uint64_t Rotate();
+
+    /**
+     * Number of the segment records are appended to
+     */
+    uint64_t Segment();
+
+    /**
+     * Removes segments older than the given one, once their records are in a snapshot
+     */
+    void Compact(uint64_t segment);
+
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats);
+
+private:
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    // Existing segment numbers, sorted
+    std::vector<uint64_t> _segments() const;
+    std::string _segment_path(uint64_t segment) const;
+
+    // Opens segment for append, writes magic if it is new. Returns -1 on error
+    int _open(uint64_t segment);
+
+    // Body of the writer thread
+    void _writer();
+
+    const std::string _path;
+
+    std::mutex _mutex;
+
+    // Writer waits for records
+    std::condition_variable _has_work;
+
+    // Appenders wait for durability or room in the buffer
+    std::condition_variable _written;
+
+    // Encoded records not taken by writer yet
+    std::string _pending;
+
+    // Offsets in pending buffer where new segment starts
+    std::vector<std::pair<std::size_t, uint64_t>> _rotations;
+
+    // Sequence numbers of the last appended record, the last one writer is done with and the last
+    // one on disk. Synced stops short of the first lost record
+    uint64_t _appended;
+    uint64_t _done;
+    uint64_t _synced;
+
+    uint64_t _segment;
+    bool _running;
+    bool _failed;
+
+    // Statistics
+    uint64_t _batches;
+    uint64_t _bytes;
+
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Segment being written, owned by writer thread
+    int _fd;
+    std::thread _thread;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_JOURNAL_H
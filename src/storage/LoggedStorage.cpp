@@ -0,0 +1,114 @@
+#include "LoggedStorage.h"
+
+#include <functional>
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t LoggedStorage::kStripes;
+
+LoggedStorage::LoggedStorage(std::shared_ptr<Afina::Storage> storage, std::shared_ptr<Journal> journal)
+    : _storage(std::move(storage)), _journal(std::move(journal)) {}
+
+// See LoggedStorage.h
+void LoggedStorage::Start() { _storage->Start(); }
+
+// See LoggedStorage.h
+void LoggedStorage::Stop() {
+    _journal->Stop();
+    _storage->Stop();
+}
+
+// See LoggedStorage.h
+std::size_t LoggedStorage::Recover() {
+    std::size_t count = _journal->Replay(*_storage);
+    _journal->Start();
+    return count;
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::Put(const std::string &key, const std::string &value) {
+    return _apply(Journal::Op::Put, key, value, [&]() { return _storage->Put(key, value); });
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::PutIfAbsent(const std::string &key, const std::string &value) {
+    return _apply(Journal::Op::Put, key, value, [&]() { return _storage->PutIfAbsent(key, value); });
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::Set(const std::string &key, const std::string &value) {
+    return _apply(Journal::Op::Put, key, value, [&]() { return _storage->Set(key, value); });
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::Delete(const std::string &key) {
+    return _apply(Journal::Op::Delete, key, std::string(), [&]() { return _storage->Delete(key); });
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::Get(const std::string &key, std::string &value) { return _storage->Get(key, value); }
+
+// See LoggedStorage.h
+void LoggedStorage::GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                            std::vector<bool> &found) {
+    _storage->GetMany(keys, values, found);
+}
+
+// See LoggedStorage.h
+void LoggedStorage::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    _storage->Stats(stats);
+    _journal->Stats(stats);
+}
+
+// See LoggedStorage.h
+int LoggedStorage::NodeOf(const std::string &key) const { return _storage->NodeOf(key); }
+
+// See LoggedStorage.h
+void LoggedStorage::ForEach(const Visitor &visitor) { _storage->ForEach(visitor); }
+
+// See LoggedStorage.h
+void LoggedStorage::Quiesce(const std::function<void()> &f) {
+    // No change is between apply and log while all stripes are held
+    _quiesce(0, [this, &f]() {
+        _storage->Quiesce([this, &f]() {
+            _journal->Rotate();
+            f();
+        });
+    });
+}
+
+// See LoggedStorage.h
+bool LoggedStorage::Restore(const std::string &key, const std::string &value) { return _storage->Restore(key, value); }
+
+Concurrency::TracedMutex &LoggedStorage::_stripe(const std::string &key) {
+    return _stripes[std::hash<std::string>()(key) % kStripes];
+}
+
+template <typename F>
+bool LoggedStorage::_apply(Journal::Op op, const std::string &key, const std::string &value, F change) {
+    uint64_t record;
+    {
+        std::lock_guard<Concurrency::TracedMutex> lock(_stripe(key));
+        if (!change()) {
+            return false;
+        }
+        record = _journal->Append(op, key, value);
+    }
+
+    // Group commit: many requests wait for the same fdatasync. Change stays in memory when it is
+    // lost, but client isn't told it is stored
+    return _journal->Wait(record);
+}
+
+void LoggedStorage::_quiesce(std::size_t stripe, const std::function<void()> &f) {
+    if (stripe == kStripes) {
+        f();
+        return;
+    }
+    std::lock_guard<Concurrency::TracedMutex> lock(_stripes[stripe]);
+    _quiesce(stripe + 1, f);
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,106 @@
+#ifndef AFINA_STORAGE_LOGGED_STORAGE_H
+#define AFINA_STORAGE_LOGGED_STORAGE_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Tsc.h>
+
+#include "Journal.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage with write ahead log
+ * Applies changes to the underlying storage and appends them to the journal, then waits until
+ * journal batch with the change is synced. Change is applied and logged under a lock striped by
+ * key, so records of the same key are logged in the order they were applied, while changes of
+ * different keys don't contend here.
+ *
+ * Set and PutIfAbsent are logged as puts of the resulting value. Restore is not logged: it only
+ * loads snapshot which is the base journal is replayed over.
+ *
+ * Quiesce starts a new journal segment at the point the storage is frozen, so snapshot written
+ * under it covers exactly segments before that one.
+ */
+class LoggedStorage : public Afina::Storage {
+public:
+    LoggedStorage(std::shared_ptr<Afina::Storage> storage, std::shared_ptr<Journal> journal);
+    ~LoggedStorage() {}
+
+    // Implements Afina::Storage interface
+    void Start() override;
+
+    // Implements Afina::Storage interface, flushes journal first
+    void Stop() override;
+
+    /**
+     * Replays journal into the underlying storage and starts logging. Should be called once snapshot
+     * (if any) is loaded
+     *
+     * @return number of records replayed
+     */
+    std::size_t Recover();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                 std::vector<bool> &found) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    int NodeOf(const std::string &key) const override;
+
+    // Implements Afina::Storage interface
+    void ForEach(const Visitor &visitor) override;
+
+    // Implements Afina::Storage interface, rotates journal segment
+    void Quiesce(const std::function<void()> &f) override;
+
+    // Implements Afina::Storage interface, stripes don't stop operations of the wrapped storage
+    bool CanQuiesce() const override { return _storage->CanQuiesce(); }
+
+    // Implements Afina::Storage interface
+    bool Restore(const std::string &key, const std::string &value) override;
+
+private:
+    static constexpr std::size_t kStripes = 64;
+
+    Concurrency::TracedMutex &_stripe(const std::string &key);
+
+    // Applies change under the key stripe and logs it if it took place
+    template <typename F> bool _apply(Journal::Op op, const std::string &key, const std::string &value, F change);
+
+    // Locks stripes starting from the given one and runs f under all of them
+    void _quiesce(std::size_t stripe, const std::function<void()> &f);
+
+    std::shared_ptr<Afina::Storage> _storage;
+    std::shared_ptr<Journal> _journal;
+
+    std::array<Concurrency::TracedMutex, kStripes> _stripes;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_LOGGED_STORAGE_H
@@ -0,0 +1,508 @@
+#include "MappedStorage.h"
+#include "Encoding.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+const char kMagic[8] = {'A', 'F', 'M', 'A', 'P', '0', '0', '1'};
+
+// Header takes the whole first page, index starts on a page boundary as well as the log
+const std::size_t kPage = 4096;
+
+// Record flags
+const uint32_t kTombstone = 1;
+const uint32_t kWrap = 2;
+
+uint64_t key_hash(const std::string &key) { return fnv1a(kFnvOffset, key.data(), key.size()); }
+
+std::size_t round_up(std::size_t n, std::size_t align) { return (n + align - 1) / align * align; }
+
+std::size_t pow2_at_least(std::size_t n) {
+    std::size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+std::size_t file_size(std::size_t arena_size, std::size_t slots) {
+    return kPage + round_up(slots * 2 * sizeof(uint64_t), kPage) + arena_size;
+}
+
+std::runtime_error io_error(const std::string &what, const std::string &path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+struct MappedStorage::Header {
+    char magic[8];
+
+    // Geometry, fixed when file is created
+    uint64_t arena_size;
+    uint64_t index_slots;
+    uint64_t geometry_checksum;
+
+    // Log occupies [head, tail) modulo arena size, used counts bytes in it including wrap gap
+    uint64_t head;
+    uint64_t tail;
+    uint64_t used;
+
+    // Number of entries in the index
+    uint64_t items;
+
+    // Set when file was closed properly, so index could be trusted
+    uint64_t clean;
+
+    uint64_t Geometry() const {
+        uint64_t hash = fnv1a(kFnvOffset, magic, sizeof(magic));
+        hash = fnv1a(hash, &arena_size, sizeof(arena_size));
+        return fnv1a(hash, &index_slots, sizeof(index_slots));
+    }
+};
+
+struct MappedStorage::Slot {
+    uint64_t hash;
+
+    // Offset of the record in the log plus one, 0 if slot is empty
+    uint64_t offset;
+};
+
+struct MappedStorage::Record {
+    uint32_t checksum;
+    uint32_t flags;
+    uint32_t key_size;
+    uint32_t value_size;
+
+    char *key() { return reinterpret_cast<char *>(this + 1); }
+    char *value() { return key() + key_size; }
+
+    // Bytes record takes in the log
+    std::size_t span() const { return round_up(sizeof(Record) + key_size + value_size, sizeof(uint64_t)); }
+
+    bool Is(const std::string &k) { return key_size == k.size() && std::memcmp(key(), k.data(), key_size) == 0; }
+
+    uint32_t Checksum() {
+        uint64_t hash = fnv1a(kFnvOffset, &flags, 3 * sizeof(uint32_t));
+        return static_cast<uint32_t>(fnv1a(hash, key(), key_size + value_size));
+    }
+};
+
+MappedStorage::MappedStorage(const std::string &path, std::size_t arena_size, std::size_t expected_items)
+    : _fd(-1), _data(nullptr), _size(0), _hits(0), _misses(0), _evictions(0) {
+    static_assert(sizeof(Header) <= kPage, "Header must fit into the first page");
+    static_assert(sizeof(Record) % sizeof(uint64_t) == 0, "Records must stay aligned");
+
+    arena_size = round_up(std::max(arena_size, kPage), kPage);
+    std::size_t slots = expected_items > 0 ? expected_items + expected_items / 3 + 1 : arena_size / 128;
+    slots = pow2_at_least(std::max<std::size_t>(slots, 1024));
+
+    _fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        throw io_error("Failed to open", path);
+    }
+
+    // Existing file keeps its geometry if header is fine
+    struct stat st;
+    if (fstat(_fd, &st) != 0) {
+        close(_fd);
+        throw io_error("Failed to stat", path);
+    }
+
+    bool existing = false;
+    if (std::size_t(st.st_size) >= kPage) {
+        Header header;
+        existing = pread(_fd, &header, sizeof(header), 0) == sizeof(header) &&
+                   std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                   header.geometry_checksum == header.Geometry() &&
+                   std::size_t(st.st_size) == file_size(header.arena_size, header.index_slots);
+        if (existing) {
+            arena_size = header.arena_size;
+            slots = header.index_slots;
+        }
+    }
+
+    _size = file_size(arena_size, slots);
+    if (!existing && (ftruncate(_fd, 0) != 0 || ftruncate(_fd, _size) != 0)) {
+        close(_fd);
+        throw io_error("Failed to resize", path);
+    }
+
+    void *data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (data == MAP_FAILED) {
+        close(_fd);
+        throw io_error("Failed to map", path);
+    }
+    _data = static_cast<char *>(data);
+    _header = reinterpret_cast<Header *>(_data);
+    _slots = reinterpret_cast<Slot *>(_data + kPage);
+    _arena = _data + _size - arena_size;
+
+    if (!existing || !_valid_geometry()) {
+        _format(arena_size, slots);
+        _state = "created";
+    } else if (!_header->clean || !_consistent()) {
+        _recover();
+        _state = "recovered";
+    } else {
+        _state = "clean";
+    }
+
+    // Crash from now on must be noticed by the next open
+    _header->clean = 0;
+    msync(_data, kPage, MS_SYNC);
+}
+
+MappedStorage::~MappedStorage() {
+    msync(_data, _size, MS_SYNC);
+    _header->clean = 1;
+    msync(_data, kPage, MS_SYNC);
+    munmap(_data, _size);
+    close(_fd);
+}
+
+// See MappedStorage.h
+bool MappedStorage::Put(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    return _put(key, key_hash(key), value);
+}
+
+// See MappedStorage.h
+bool MappedStorage::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    const uint64_t hash = key_hash(key);
+    if (_find(key, hash) != nullptr) {
+        return false;
+    }
+    return _put(key, hash, value);
+}
+
+// See MappedStorage.h
+bool MappedStorage::Set(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    const uint64_t hash = key_hash(key);
+    if (_find(key, hash) == nullptr) {
+        return false;
+    }
+    return _put(key, hash, value);
+}
+
+// See MappedStorage.h
+bool MappedStorage::Delete(const std::string &key) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    const uint64_t hash = key_hash(key);
+    if (_find(key, hash) == nullptr) {
+        return false;
+    }
+
+    // Tombstone keeps key deleted if index has to be rebuilt from the log. Appending it could evict
+    // the entry itself, so slot is looked up again
+    _append(kTombstone, key, std::string());
+    Slot *slot = _find(key, hash);
+    if (slot != nullptr) {
+        _erase(slot);
+    }
+    return true;
+}
+
+// See MappedStorage.h
+bool MappedStorage::Get(const std::string &key, std::string &value) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    return _get(key, value);
+}
+
+// See MappedStorage.h
+void MappedStorage::GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                            std::vector<bool> &found) {
+    values.resize(keys.size());
+    found.resize(keys.size());
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        found[i] = _get(*keys[i], values[i]);
+    }
+}
+
+bool MappedStorage::_get(const std::string &key, std::string &value) {
+    Slot *slot = _find(key, key_hash(key));
+    if (slot == nullptr) {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    Record *record = _record(slot->offset - 1);
+    value.assign(record->value(), record->value_size);
+    return true;
+}
+
+// See MappedStorage.h
+void MappedStorage::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    stats.emplace_back("curr_items", std::to_string(_header->items));
+    stats.emplace_back("bytes", std::to_string(_header->used));
+    stats.emplace_back("limit_maxbytes", std::to_string(_header->arena_size));
+    stats.emplace_back("index_bytes", std::to_string(_header->index_slots * sizeof(Slot)));
+    stats.emplace_back("lookup_hits", std::to_string(_hits));
+    stats.emplace_back("lookup_misses", std::to_string(_misses));
+    stats.emplace_back("evictions", std::to_string(_evictions));
+}
+
+// See MappedStorage.h
+void MappedStorage::ForEach(const Visitor &visitor) {
+    std::string key, value;
+    uint64_t pos = _header->head;
+    for (uint64_t scanned = 0; scanned < _header->used;) {
+        const uint64_t room = _header->arena_size - pos;
+        if (room < sizeof(Record) || (_record(pos)->flags & kWrap) != 0) {
+            scanned += room;
+            pos = 0;
+            continue;
+        }
+
+        Record *record = _record(pos);
+        if ((record->flags & kTombstone) == 0) {
+            key.assign(record->key(), record->key_size);
+            Slot *slot = _find(key, key_hash(key));
+            if (slot != nullptr && slot->offset == pos + 1) {
+                value.assign(record->value(), record->value_size);
+                visitor(key, value);
+            }
+        }
+
+        scanned += record->span();
+        pos = (pos + record->span()) % _header->arena_size;
+    }
+}
+
+// See MappedStorage.h
+void MappedStorage::Quiesce(const std::function<void()> &f) {
+    std::lock_guard<Concurrency::TracedMutex> lock(_mutex);
+    f();
+}
+
+bool MappedStorage::_valid_geometry() const {
+    const Header &h = *_header;
+    return h.index_slots > 0 && (h.index_slots & (h.index_slots - 1)) == 0 && h.arena_size > 0 &&
+           h.arena_size % kPage == 0;
+}
+
+bool MappedStorage::_consistent() const {
+    const Header &h = *_header;
+    return h.head < h.arena_size && h.tail < h.arena_size && h.used <= h.arena_size && h.items <= _max_items() &&
+           (h.head + h.used) % h.arena_size == h.tail;
+}
+
+void MappedStorage::_format(std::size_t arena_size, std::size_t slots) {
+    std::memset(_header, 0, kPage);
+    std::memcpy(_header->magic, kMagic, sizeof(kMagic));
+    _header->arena_size = arena_size;
+    _header->index_slots = slots;
+    _header->geometry_checksum = _header->Geometry();
+    std::memset(_slots, 0, slots * sizeof(Slot));
+}
+
+void MappedStorage::_recover() {
+    Header &h = *_header;
+    std::memset(_slots, 0, h.index_slots * sizeof(Slot));
+    h.items = 0;
+
+    // Append moves used before tail and eviction moves used before head, so after a crash between
+    // the two stores either used or distance from head to tail is one step short. The longer of them
+    // covers the whole log, records beyond its end are cut by checksum
+    if (h.head >= h.arena_size || h.head % sizeof(uint64_t) != 0) {
+        h.head = 0;
+    }
+    uint64_t length = h.used <= h.arena_size ? h.used : 0;
+    if (h.tail < h.arena_size) {
+        length = std::max(length, (h.tail + h.arena_size - h.head) % h.arena_size);
+    }
+
+    std::string key;
+    uint64_t pos = h.head, scanned = 0;
+    while (scanned < length) {
+        const uint64_t room = h.arena_size - pos;
+        if (room < sizeof(Record) || (_record(pos)->flags & kWrap) != 0) {
+            scanned += room;
+            pos = 0;
+            continue;
+        }
+
+        Record *record = _record(pos);
+        if (sizeof(Record) + uint64_t(record->key_size) + record->value_size > room ||
+            scanned + record->span() > length || record->checksum != record->Checksum()) {
+            break;
+        }
+
+        key.assign(record->key(), record->key_size);
+        const uint64_t hash = key_hash(key);
+        if ((record->flags & kTombstone) != 0) {
+            Slot *slot = _find(key, hash);
+            if (slot != nullptr) {
+                _erase(slot);
+            }
+        } else if (h.items < _max_items() || _find(key, hash) != nullptr) {
+            _index_put(key, hash, pos);
+        }
+
+        scanned += record->span();
+        pos = (pos + record->span()) % h.arena_size;
+    }
+
+    // Everything after the first broken record is lost
+    h.used = scanned;
+    h.tail = pos;
+    if (h.used == 0) {
+        h.head = h.tail = 0;
+    }
+}
+
+bool MappedStorage::_put(const std::string &key, uint64_t hash, const std::string &value) {
+    if (sizeof(Record) + key.size() + value.size() > _header->arena_size) {
+        return false;
+    }
+
+    if (_find(key, hash) == nullptr) {
+        // Index must keep free slots to terminate probing
+        while (_header->items >= _max_items() && _header->used > 0) {
+            _evict_head();
+        }
+    }
+    _index_put(key, hash, _append(0, key, value));
+    return true;
+}
+
+int64_t MappedStorage::_append(uint32_t flags, const std::string &key, const std::string &value) {
+    Header &h = *_header;
+    const std::size_t span = round_up(sizeof(Record) + key.size() + value.size(), sizeof(uint64_t));
+    if (span > h.arena_size) {
+        return -1;
+    }
+
+    for (;;) {
+        if (h.used == 0) {
+            h.head = h.tail = 0;
+        }
+
+        if (h.tail > h.head || h.used == 0) {
+            // Free space is [tail, end) and [0, head)
+            const uint64_t room = h.arena_size - h.tail;
+            if (room >= span) {
+                break;
+            }
+
+            // Skip the end of the log, gap is accounted as used until head passes it
+            if (room >= sizeof(Record)) {
+                std::memset(_record(h.tail), 0, sizeof(Record));
+                _record(h.tail)->flags = kWrap;
+            }
+            h.used += room;
+            h.tail = 0;
+        } else if (h.head - h.tail >= span) {
+            // Free space is [tail, head)
+            break;
+        } else {
+            _evict_head();
+        }
+    }
+
+    const uint64_t offset = h.tail;
+    Record *record = _record(offset);
+    record->flags = flags;
+    record->key_size = key.size();
+    record->value_size = value.size();
+    std::memcpy(record->key(), key.data(), key.size());
+    std::memcpy(record->value(), value.data(), value.size());
+    record->checksum = record->Checksum();
+
+    h.used += span;
+    h.tail = (h.tail + span) % h.arena_size;
+    return offset;
+}
+
+void MappedStorage::_evict_head() {
+    Header &h = *_header;
+    const uint64_t room = h.arena_size - h.head;
+    if (room < sizeof(Record) || (_record(h.head)->flags & kWrap) != 0) {
+        h.used -= room;
+        h.head = 0;
+    } else {
+        Record *record = _record(h.head);
+        if ((record->flags & kTombstone) == 0) {
+            std::string key(record->key(), record->key_size);
+            Slot *slot = _find(key, key_hash(key));
+            if (slot != nullptr && slot->offset == h.head + 1) {
+                _erase(slot);
+                _evictions++;
+            }
+        }
+        h.used -= record->span();
+        h.head = (h.head + record->span()) % h.arena_size;
+    }
+
+    if (h.used == 0) {
+        h.head = h.tail = 0;
+    }
+}
+
+void MappedStorage::_index_put(const std::string &key, uint64_t hash, uint64_t offset) {
+    Slot *slot = _find(key, hash);
+    if (slot == nullptr) {
+        const uint64_t mask = _header->index_slots - 1;
+        uint64_t i = hash & mask;
+        while (_slots[i].offset != 0) {
+            i = (i + 1) & mask;
+        }
+        slot = &_slots[i];
+        slot->hash = hash;
+        _header->items++;
+    }
+    slot->offset = offset + 1;
+}
+
+MappedStorage::Slot *MappedStorage::_find(const std::string &key, uint64_t hash) const {
+    const uint64_t mask = _header->index_slots - 1;
+    for (uint64_t i = hash & mask; _slots[i].offset != 0; i = (i + 1) & mask) {
+        if (_slots[i].hash == hash && _record(_slots[i].offset - 1)->Is(key)) {
+            return &_slots[i];
+        }
+    }
+    return nullptr;
+}
+
+void MappedStorage::_erase(Slot *slot) {
+    // Backward shift: move up entries of the probe chain which could be reached from the hole
+    const uint64_t mask = _header->index_slots - 1;
+    uint64_t hole = slot - _slots;
+    for (uint64_t i = (hole + 1) & mask; _slots[i].offset != 0; i = (i + 1) & mask) {
+        const uint64_t home = _slots[i].hash & mask;
+        const bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            _slots[hole] = _slots[i];
+            hole = i;
+        }
+    }
+    _slots[hole].hash = 0;
+    _slots[hole].offset = 0;
+    _header->items--;
+}
+
+MappedStorage::Record *MappedStorage::_record(uint64_t offset) const {
+    return reinterpret_cast<Record *>(_arena + offset);
+}
+
+std::size_t MappedStorage::_max_items() const { return _header->index_slots / 4 * 3; }
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,144 @@
+#ifndef AFINA_STORAGE_MAPPED_STORAGE_H
+#define AFINA_STORAGE_MAPPED_STORAGE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Tsc.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage in a memory mapped file
+ * Entries and index live in a file mapped with MAP_SHARED, so they survive restart of the process and
+ * come back without load phase: pages are read lazily from the page cache as keys are touched.
+ *
+ * File consists of a header, open addressing hash index (linear probing, backward shift deletion) and
+ * circular log of records. Put appends a record at the tail, Delete appends a tombstone, space is
+ * reclaimed by moving the head forward and dropping index entries of records it passes. So eviction
+ * order is FIFO by the last write, Get doesn't refresh entries.
+ *
+ * Header has a "clean" flag which is cleared while file is open. If process died without closing the
+ * file, index is rebuilt on open by scanning the log from head and checking record checksums, the scan
+ * stops at the first broken record.
+ *
+ * Existing file keeps its geometry, requested sizes apply to new files only. Thread safe: every
+ * operation takes the global lock.
+ */
+class MappedStorage : public Afina::Storage {
+public:
+    /**
+     * @param path file to keep data in, created if doesn't exist or isn't a valid storage file
+     * @param arena_size bytes of the log, records including headers
+     * @param expected_items number of entries to size index for, derived from arena size if 0
+     */
+    MappedStorage(const std::string &path, std::size_t arena_size, std::size_t expected_items = 0);
+    ~MappedStorage();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface, all keys are looked up under one lock
+    void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                 std::vector<bool> &found) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    void ForEach(const Visitor &visitor) override;
+
+    // Implements Afina::Storage interface
+    void Quiesce(const std::function<void()> &f) override;
+
+    // Implements Afina::Storage interface
+    bool CanQuiesce() const override { return true; }
+
+    /**
+     * How file was opened: "created", "clean" or "recovered"
+     */
+    const std::string &OpenState() const { return _state; }
+
+private:
+    struct Header;
+    struct Slot;
+    struct Record;
+
+    MappedStorage(const MappedStorage &) = delete;
+    MappedStorage &operator=(const MappedStorage &) = delete;
+
+    // Whether geometry of the mapped file is usable, log positions aren't checked
+    bool _valid_geometry() const;
+
+    // Whether log positions agree with each other, they are updated one by one and crash could tear them
+    bool _consistent() const;
+
+    // Initializes empty storage of the given geometry
+    void _format(std::size_t arena_size, std::size_t slots);
+
+    // Rebuilds index and log positions from the records, truncating log at the first broken one
+    void _recover();
+
+    // Looks entry up, caller holds the lock
+    bool _get(const std::string &key, std::string &value);
+
+    // Inserts or replaces entry, caller holds the lock
+    bool _put(const std::string &key, uint64_t hash, const std::string &value);
+
+    // Writes record at the tail, evicting from the head as needed. Returns its offset, or -1 if it
+    // is larger than the whole log
+    int64_t _append(uint32_t flags, const std::string &key, const std::string &value);
+
+    // Drops record at the head of the log
+    void _evict_head();
+
+    // Makes index point key to the record at offset
+    void _index_put(const std::string &key, uint64_t hash, uint64_t offset);
+
+    Slot *_find(const std::string &key, uint64_t hash) const;
+    void _erase(Slot *slot);
+
+    Record *_record(uint64_t offset) const;
+
+    // Max number of entries index could hold
+    std::size_t _max_items() const;
+
+    std::string _state;
+
+    int _fd;
+    char *_data;
+    std::size_t _size;
+
+    // Parts of the mapping
+    Header *_header;
+    Slot *_slots;
+    char *_arena;
+
+    // Lookups which found and didn't find the key, and entries dropped to make room for new ones
+    // since the file was opened. Log keeps no access times, so idle time of evicted ones is unknown
+    uint64_t _hits;
+    uint64_t _misses;
+    uint64_t _evictions;
+
+    Concurrency::TracedMutex _mutex;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_MAPPED_STORAGE_H
@@ -0,0 +1,198 @@
+#include "RegionLRU.h"
+
+#include <cstring>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Mempool.h>
+
+namespace Afina {
+namespace Backend {
+
+// Pool shared by nodes of all instances, never destroyed
+static Allocator::Mempool &node_pool(std::size_t size) {
+    static Allocator::Mempool *pool = new Allocator::Mempool(size);
+    return *pool;
+}
+
+// See RegionLRU.h
+void *RegionLRU::lru_node::operator new(std::size_t size) { return node_pool(sizeof(lru_node)).Alloc(); }
+
+// See RegionLRU.h
+void RegionLRU::lru_node::operator delete(void *ptr) { node_pool(sizeof(lru_node)).Free(ptr); }
+
+RegionLRU::RegionLRU(size_t max_size, const Allocator::PagePolicy &pages)
+    : _max_size(max_size), _region(max_size, alignof(std::max_align_t), pages), _allocator(_region.data(), max_size),
+      _lru_head(nullptr), _lru_tail(nullptr) {}
+
+RegionLRU::~RegionLRU() {
+    while (_lru_head != nullptr) {
+        lru_node *next = _lru_head->next;
+        delete _lru_head;
+        _lru_head = next;
+    }
+}
+
+// See RegionLRU.h
+bool RegionLRU::Put(const std::string &key, const std::string &value) {
+    auto elem = _lru_index.find(key);
+    if (elem == _lru_index.end()) {
+        return _insert(key, value);
+    }
+    _to_tail(elem->second);
+    return _store(*elem->second, value);
+}
+
+// See RegionLRU.h
+bool RegionLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    if (_lru_index.find(key) != _lru_index.end()) {
+        return false;
+    }
+    return _insert(key, value);
+}
+
+// See RegionLRU.h
+bool RegionLRU::Set(const std::string &key, const std::string &value) {
+    auto elem = _lru_index.find(key);
+    if (elem == _lru_index.end()) {
+        return false;
+    }
+    _to_tail(elem->second);
+    return _store(*elem->second, value);
+}
+
+// See RegionLRU.h
+bool RegionLRU::Delete(const std::string &key) {
+    auto elem = _lru_index.find(key);
+    if (elem == _lru_index.end()) {
+        return false;
+    }
+    _delete_node(elem->second);
+    return true;
+}
+
+// See RegionLRU.h
+bool RegionLRU::Get(const std::string &key, std::string &value) {
+    auto elem = _lru_index.find(key);
+    if (elem == _lru_index.end()) {
+        _cache.Miss();
+        return false;
+    }
+
+    _cache.Hit();
+    lru_node *node = elem->second;
+    value.assign(static_cast<const char *>(node->value.get()), node->value_size);
+    _to_tail(node);
+    return true;
+}
+
+// See RegionLRU.h
+void RegionLRU::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    stats.emplace_back("curr_items", std::to_string(_lru_index.size()));
+    stats.emplace_back("limit_maxbytes", std::to_string(_max_size));
+    _cache.Report(stats);
+}
+
+// See RegionLRU.h
+void RegionLRU::ForEach(const Visitor &visitor) {
+    std::string value;
+    for (lru_node *node = _lru_head; node != nullptr; node = node->next) {
+        value.assign(static_cast<const char *>(node->value.get()), node->value_size);
+        visitor(node->key, value);
+    }
+}
+
+bool RegionLRU::_store(lru_node &node, const std::string &value) {
+    if (value.size() > _allocator.max_size()) {
+        // Would never fit, keep everything else in place
+        return false;
+    }
+
+    bool defragmented = false;
+    for (;;) {
+        try {
+            _allocator.realloc(node.value, value.size());
+            break;
+        } catch (Allocator::AllocError &) {
+        }
+
+        // Free space could be spread between blocks, compact it before throwing data away
+        if (!defragmented) {
+            _allocator.defrag();
+            defragmented = true;
+            continue;
+        }
+
+        if (_lru_head == &node) {
+            // Nothing else to evict, value doesn't fit into the region
+            return false;
+        }
+        _cache.Evicted(_lru_head->touched);
+        _delete_node(_lru_head);
+        defragmented = false;
+    }
+
+    std::memcpy(node.value.get(), value.data(), value.size());
+    _cache.Removed(node.key.size() + node.value_size);
+    _cache.Added(node.key.size() + value.size());
+    node.value_size = value.size();
+    return true;
+}
+
+bool RegionLRU::_insert(const std::string &key, const std::string &value) {
+    if (value.size() > _allocator.max_size()) {
+        return false;
+    }
+
+    lru_node *node = new lru_node(key);
+    node->prev = _lru_tail;
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = node;
+    } else {
+        _lru_head = node;
+    }
+    _lru_tail = node;
+    _lru_index.insert(std::make_pair(std::cref(node->key), node));
+    _cache.Added(key.size());
+
+    if (!_store(*node, value)) {
+        _delete_node(node);
+        return false;
+    }
+    return true;
+}
+
+void RegionLRU::_delete_node(lru_node *node) {
+    _cache.Removed(node->key.size() + node->value_size);
+    _lru_index.erase(node->key);
+    _unlink(node);
+    _allocator.free(node->value);
+    delete node;
+}
+
+void RegionLRU::_unlink(lru_node *node) {
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        _lru_head = node->next;
+    }
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        _lru_tail = node->prev;
+    }
+    node->prev = node->next = nullptr;
+}
+
+void RegionLRU::_to_tail(lru_node *node) {
+    node->touched = Concurrency::Tsc::Now();
+    if (node == _lru_tail) {
+        return;
+    }
+    _unlink(node);
+    node->prev = _lru_tail;
+    _lru_tail->next = node;
+    _lru_tail = node;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,114 @@
+#ifndef AFINA_STORAGE_REGION_LRU_H
+#define AFINA_STORAGE_REGION_LRU_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Pages.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+#include <afina/concurrency/Tsc.h>
+
+#include "CacheStats.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU with values in a fixed memory region
+ * All values live in the single region of max_size bytes managed by the compacting allocator, so
+ * memory taken by values never grows beyond it and doesn't fragment over time: when there is no
+ * free block large enough region gets defragmented first and only then least recently used entries
+ * are evicted. Keys and index stay on the heap.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class RegionLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size size of the region for values, in bytes
+     * @param pages pages to back the region with
+     */
+    RegionLRU(size_t max_size = 1024, const Allocator::PagePolicy &pages = Allocator::PagePolicy());
+    ~RegionLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    void ForEach(const Visitor &visitor) override;
+
+    /**
+     * Kind of pages system gave for the region
+     */
+    Allocator::PageKind Pages() const { return _region.kind(); }
+
+private:
+    // LRU cache node, value bytes are in the region
+    struct lru_node {
+        const std::string key;
+        Allocator::Pointer value;
+        std::size_t value_size;
+        lru_node *prev;
+        lru_node *next;
+
+        // TSC time of the last access
+        uint64_t touched;
+
+        lru_node(const std::string &_k)
+            : key(_k), value_size(0), prev(nullptr), next(nullptr), touched(Concurrency::Tsc::Now()) {}
+
+        // Nodes come from the shared mempool instead of malloc
+        static void *operator new(std::size_t size);
+        static void operator delete(void *ptr);
+    };
+
+    using back_node = std::map<std::reference_wrapper<const std::string>, lru_node *, std::less<std::string>>;
+
+    // Places value into the node's block, evicting other entries if needed
+    bool _store(lru_node &node, const std::string &value);
+
+    bool _insert(const std::string &key, const std::string &value);
+
+    void _delete_node(lru_node *node);
+
+    void _unlink(lru_node *node);
+    void _to_tail(lru_node *node);
+
+    // Memory owned by storage and managed by allocator
+    const std::size_t _max_size;
+    Allocator::Mapping _region;
+    Allocator::Simple _allocator;
+
+    // List ordered by "freshness": head wasn't used for the longest time
+    lru_node *_lru_head;
+    lru_node *_lru_tail;
+
+    // Index of nodes from list above
+    back_node _lru_index;
+
+    // Hits, misses, evictions and entries by size class
+    CacheStats _cache;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_REGION_LRU_H
@@ -0,0 +1,153 @@
+#include "ShardedStorage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+ShardedStorage::ShardedStorage(std::vector<std::shared_ptr<Afina::Storage>> shards, std::vector<int> nodes)
+    : _shards(std::move(shards)), _nodes(std::move(nodes)) {
+    if (_shards.empty()) {
+        throw std::runtime_error("Sharded storage needs at least one shard");
+    }
+    if (!_nodes.empty() && _nodes.size() != _shards.size()) {
+        throw std::runtime_error("Node must be given for every shard");
+    }
+}
+
+// See ShardedStorage.h
+void ShardedStorage::Start() {
+    for (auto &shard : _shards) {
+        shard->Start();
+    }
+}
+
+// See ShardedStorage.h
+void ShardedStorage::Stop() {
+    for (auto &shard : _shards) {
+        shard->Stop();
+    }
+}
+
+// See ShardedStorage.h
+bool ShardedStorage::Put(const std::string &key, const std::string &value) {
+    return _shards[ShardOf(key)]->Put(key, value);
+}
+
+// See ShardedStorage.h
+bool ShardedStorage::PutIfAbsent(const std::string &key, const std::string &value) {
+    return _shards[ShardOf(key)]->PutIfAbsent(key, value);
+}
+
+// See ShardedStorage.h
+bool ShardedStorage::Set(const std::string &key, const std::string &value) {
+    return _shards[ShardOf(key)]->Set(key, value);
+}
+
+// See ShardedStorage.h
+bool ShardedStorage::Delete(const std::string &key) { return _shards[ShardOf(key)]->Delete(key); }
+
+// See ShardedStorage.h
+bool ShardedStorage::Get(const std::string &key, std::string &value) {
+    return _shards[ShardOf(key)]->Get(key, value);
+}
+
+// See ShardedStorage.h
+void ShardedStorage::GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                             std::vector<bool> &found) {
+    values.resize(keys.size());
+    found.resize(keys.size());
+
+    // Positions of keys ordered by shard, so keys of a shard come in a row
+    std::vector<std::pair<std::size_t, std::size_t>> order(keys.size());
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        order[i] = std::make_pair(ShardOf(*keys[i]), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<const std::string *> part_keys;
+    std::vector<std::string> part_values;
+    std::vector<bool> part_found;
+    for (std::size_t begin = 0, end = 0; begin < order.size(); begin = end) {
+        part_keys.clear();
+        for (end = begin; end < order.size() && order[end].first == order[begin].first; end++) {
+            part_keys.push_back(keys[order[end].second]);
+        }
+
+        _shards[order[begin].first]->GetMany(part_keys, part_values, part_found);
+        for (std::size_t i = begin; i < end; i++) {
+            values[order[i].second].swap(part_values[i - begin]);
+            found[order[i].second] = part_found[i - begin];
+        }
+    }
+}
+
+// See ShardedStorage.h
+void ShardedStorage::Stats(std::vector<std::pair<std::string, std::string>> &stats) {
+    std::vector<std::pair<std::string, std::string>> total;
+    for (auto &shard : _shards) {
+        std::vector<std::pair<std::string, std::string>> part;
+        shard->Stats(part);
+        for (std::size_t i = 0; i < part.size(); i++) {
+            // Shards of the same kind report the same names in the same order
+            if (i < total.size() && total[i].first == part[i].first) {
+                total[i].second = std::to_string(std::strtoull(total[i].second.c_str(), nullptr, 10) +
+                                                 std::strtoull(part[i].second.c_str(), nullptr, 10));
+            } else if (i >= total.size()) {
+                total.push_back(part[i]);
+            }
+        }
+    }
+    stats.insert(stats.end(), total.begin(), total.end());
+}
+
+// See ShardedStorage.h
+void ShardedStorage::ForEach(const Visitor &visitor) {
+    for (auto &shard : _shards) {
+        shard->ForEach(visitor);
+    }
+}
+
+// See ShardedStorage.h
+void ShardedStorage::Quiesce(const std::function<void()> &f) { _quiesce(0, f); }
+
+// See ShardedStorage.h
+bool ShardedStorage::CanQuiesce() const {
+    for (auto &shard : _shards) {
+        if (!shard->CanQuiesce()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See ShardedStorage.h
+bool ShardedStorage::Restore(const std::string &key, const std::string &value) {
+    return _shards[ShardOf(key)]->Restore(key, value);
+}
+
+void ShardedStorage::_quiesce(std::size_t shard, const std::function<void()> &f) {
+    if (shard == _shards.size()) {
+        f();
+        return;
+    }
+    _shards[shard]->Quiesce([this, shard, &f]() { _quiesce(shard + 1, f); });
+}
+
+// See ShardedStorage.h
+int ShardedStorage::NodeOf(const std::string &key) const { return _nodes.empty() ? -1 : _nodes[ShardOf(key)]; }
+
+// See ShardedStorage.h
+std::size_t ShardedStorage::ShardOf(const std::string &key) const {
+    // Shard's own hash table picks bucket by the same hash, mix it so that keys of one shard
+    // still spread over all buckets
+    uint64_t h = std::hash<std::string>()(key) * 0x9E3779B97F4A7C15ull;
+    return (h >> 32) % _shards.size();
+}
+
+} // namespace Backend
+} // namespace Afina
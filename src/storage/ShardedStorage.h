@@ -0,0 +1,94 @@
+#ifndef AFINA_STORAGE_SHARDED_STORAGE_H
+#define AFINA_STORAGE_SHARDED_STORAGE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage split into independent shards
+ * Each key belongs to exactly one shard chosen by its hash, so shards don't share index, memory
+ * limit or lock and threads working on different shards don't contend. Shards themselves must be
+ * thread safe if storage is used from several threads.
+ *
+ * Statistics of all shards are summed up by name.
+ *
+ * Shards could be placed on NUMA nodes, then storage reports node owning each key so that requests
+ * get served near the data.
+ */
+class ShardedStorage : public Afina::Storage {
+public:
+    /**
+     * @param shards storages to split keys between
+     * @param nodes NUMA node of each shard, empty if shards aren't node bound
+     */
+    ShardedStorage(std::vector<std::shared_ptr<Afina::Storage>> shards, std::vector<int> nodes = {});
+    ~ShardedStorage() {}
+
+    // Implements Afina::Storage interface
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface, every shard gets all of its keys in one call
+    void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                 std::vector<bool> &found) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    int NodeOf(const std::string &key) const override;
+
+    // Implements Afina::Storage interface, shard by shard
+    void ForEach(const Visitor &visitor) override;
+
+    // Implements Afina::Storage interface, all shards are quiesced at once
+    void Quiesce(const std::function<void()> &f) override;
+
+    // Implements Afina::Storage interface, true if every shard could be quiesced
+    bool CanQuiesce() const override;
+
+    // Implements Afina::Storage interface
+    bool Restore(const std::string &key, const std::string &value) override;
+
+    /**
+     * Index of the shard the key belongs to
+     */
+    std::size_t ShardOf(const std::string &key) const;
+
+private:
+    // Quiesces shards starting from the given one and runs f under all of them
+    void _quiesce(std::size_t shard, const std::function<void()> &f);
+
+    std::vector<std::shared_ptr<Afina::Storage>> _shards;
+
+    // Node of each shard, if any
+    std::vector<int> _nodes;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARDED_STORAGE_H
@@ -1,8 +1,37 @@
 #include "SimpleLRU.h"
 
+#include <new>
+
 namespace Afina {
 namespace Backend {
 
+// Capacity of the string kept inline, without heap buffer
+static const std::size_t kInlineString = std::string().capacity();
+
+// Bytes taken by heap buffer of the string: malloc chunk including its header. Computed from the
+// capacity rather than asked from malloc, which could hand out a larger reused chunk and make
+// the same entry cost differently depending on heap history
+static std::size_t string_size(const std::string &s) {
+    if (s.capacity() <= kInlineString) {
+        return 0;
+    }
+    return Allocator::NewDeleteResource()->footprint(s.capacity() + 1);
+}
+
+// Bytes heap buffer of a fresh copy of string of the given length would take
+static std::size_t string_size(std::size_t length) {
+    if (length <= kInlineString) {
+        return 0;
+    }
+    return Allocator::NewDeleteResource()->footprint(length + 1);
+}
+
+// See SimpleLRU.h
+void SimpleLRU::NodeDeleter::operator()(lru_node *node) const {
+    node->~lru_node();
+    memory->deallocate(node, sizeof(lru_node), alignof(lru_node));
+}
+
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Put(const std::string &key, const std::string &value)
 {
@@ -48,58 +77,76 @@ bool SimpleLRU::Get(const std::string &key, std::string &value)
 {
     auto elem = _lru_index.find(key);
     if (elem == _lru_index.end()) {
+        _cache.Miss();
         return false;
     } else {
+        _cache.Hit();
         value = elem->second.get().value;
         return _node_to_tail(elem->second.get());
     }
 }
 
-bool SimpleLRU::_delete_at_iter(back_node_iter elem_iter)
+// See SimpleLRU.h
+void SimpleLRU::Stats(std::vector<std::pair<std::string, std::string>> &stats)
 {
-    std::unique_ptr<lru_node> tmp;
-    lru_node &node = elem_iter->second;
-    _cur_size -= node.key.size() + node.value.size();
-
-    // deleting from interface
-    _lru_index.erase(elem_iter);
+    stats.emplace_back("curr_items", std::to_string(_lru_index.size()));
+    stats.emplace_back("bytes", std::to_string(_cur_size));
+    stats.emplace_back("limit_maxbytes", std::to_string(_max_size));
+    stats.emplace_back("payload_bytes", std::to_string(_payload_size));
+    stats.emplace_back("index_bytes", std::to_string(_table_size()));
+    _cache.Report(stats);
+}
 
-    // deleting from list
-    if (node.next) {
-        node.next->prev = node.prev;
-    }
-    if (node.prev) {
-        tmp.swap(node.prev->next);
-        node.prev->next = std::move(node.next);
-    } else {
-        tmp.swap(_lru_head);
-        _lru_head = std::move(node.next);
+// See SimpleLRU.h
+void SimpleLRU::ForEach(const Visitor &visitor)
+{
+    for (lru_node *node = _lru_head.get(); node != nullptr; node = node->next.get()) {
+        visitor(node->key, node->value);
     }
-    return true;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Restore(const std::string &key, const std::string &value)
+{
+    // Straight to the tail, without lookup
+    return _put(key, value);
+}
+
+bool SimpleLRU::_delete_at_iter(back_node_iter elem_iter)
+{
+    return _delete_node(elem_iter->second);
 }
 
 bool SimpleLRU::_delete_node(lru_node &node_ref)
 {
-    std::unique_ptr<lru_node> tmp_ptr;
-    _cur_size -= node_ref.key.size() + node_ref.value.size();
+    {
+        node_ptr tmp_ptr(nullptr, NodeDeleter{&_memory});
+        _payload_size -= node_ref.key.size() + node_ref.value.size();
+        _cache.Removed(node_ref.key.size() + node_ref.value.size());
+        _strings_size -= string_size(node_ref.key) + string_size(node_ref.value);
 
-    _lru_index.erase(node_ref.key);
+        _lru_index.erase(node_ref.key);
 
-    if (node_ref.next) {
-        node_ref.next->prev = node_ref.prev;
-    }
-    if (node_ref.prev) {
-        tmp_ptr.swap(node_ref.prev->next);
-        node_ref.prev->next = std::move(node_ref.next);
-    } else {
-        tmp_ptr.swap(_lru_head);
-        _lru_head = std::move(node_ref.next);
+        if (node_ref.next) {
+            node_ref.next->prev = node_ref.prev;
+        } else {
+            _lru_tail = node_ref.prev;
+        }
+        if (node_ref.prev) {
+            tmp_ptr.swap(node_ref.prev->next);
+            node_ref.prev->next = std::move(node_ref.next);
+        } else {
+            tmp_ptr.swap(_lru_head);
+            _lru_head = std::move(node_ref.next);
+        }
     }
+    _cur_size = _entries_size();
     return true;
 }
 
 bool SimpleLRU::_node_to_tail(lru_node &node_ref)
 {
+    node_ref.touched = Concurrency::Tsc::Now();
     if (&node_ref == _lru_tail) {
         return true;
     }
@@ -116,23 +163,66 @@ bool SimpleLRU::_node_to_tail(lru_node &node_ref)
     return true;
 }
 
-bool SimpleLRU::_is_free(size_t need_to_free) {
+bool SimpleLRU::_is_free(size_t need_to_free, const lru_node *keep) {
     if (need_to_free > _max_size) {
         return false;
     }
-    while (_max_size - _cur_size < need_to_free) {
-        _delete_node(*_lru_head);
+    while (_cur_size + need_to_free > _max_size) {
+        if (_lru_head == nullptr || _lru_head.get() == keep) {
+            return false;
+        }
+        _evict_head();
     }
     return true;
 }
 
+void SimpleLRU::_evict_head() {
+    _cache.Evicted(_lru_head->touched);
+    _delete_node(*_lru_head);
+}
+
+void SimpleLRU::_account(const lru_node *keep) {
+    _cur_size = _entries_size();
+    while (_cur_size > _max_size && _lru_head != nullptr && _lru_head.get() != keep) {
+        _evict_head();
+    }
+}
+
+std::size_t SimpleLRU::_table_size() const {
+    // Table of a single bucket is kept inside of the map itself
+    const std::size_t buckets = _lru_index.bucket_count();
+    return buckets > 1 ? _memory.footprint(buckets * sizeof(void *)) : 0;
+}
+
+std::size_t SimpleLRU::_entries_size() const { return _memory.allocated() - _table_size() + _strings_size; }
+
+// Hash table node: link, value and cached hash code
+static const std::size_t kIndexNode = 2 * sizeof(void *) + sizeof(std::pair<const std::string *, void *>);
+
+std::size_t SimpleLRU::_entry_size(std::size_t key_size, std::size_t value_size) const {
+    const std::size_t index_node = kIndexNode;
+    return _memory.footprint(sizeof(lru_node), alignof(lru_node)) + _memory.footprint(index_node) +
+           string_size(key_size) + string_size(value_size);
+}
+
+void SimpleLRU::_reserve(std::size_t expected_items) {
+    if (expected_items == 0) {
+        return;
+    }
+    _lru_index.reserve(expected_items);
+    _pools->Reserve(sizeof(lru_node), expected_items);
+    _pools->Reserve(kIndexNode, expected_items);
+    _cur_size = _entries_size();
+}
+
 bool SimpleLRU::_put(const std::string &key, const std::string &value)
 {
-    size_t addsize = key.size() + value.size();
-    if (!_is_free(addsize)) {
+    if (!_is_free(_entry_size(key.size(), value.size()))) {
         return false;
     }
-    std::unique_ptr<lru_node> temp_ptr(new lru_node(key, value));
+
+    void *place = _memory.allocate(sizeof(lru_node), alignof(lru_node));
+    node_ptr temp_ptr(new (place) lru_node(key, value, &_memory), NodeDeleter{&_memory});
     if (_lru_tail != nullptr) {
         temp_ptr->prev = _lru_tail;
         _lru_tail->next.swap(temp_ptr);
@@ -141,9 +231,21 @@ bool SimpleLRU::_put(const std::string &key, const std::string &value)
         _lru_head.swap(temp_ptr);
         _lru_tail = _lru_head.get();
     }
-    _lru_index.insert(std::make_pair(std::reference_wrapper<const std::string>(_lru_tail->key),
-                                     std::reference_wrapper<lru_node>(*_lru_tail)));
-    _cur_size += addsize;
+    auto inserted = _lru_index.insert(std::make_pair(std::reference_wrapper<const std::string>(_lru_tail->key),
+                                                     std::reference_wrapper<lru_node>(*_lru_tail)));
+    if (!inserted.second) {
+        // Restore of the key which is already there: drop new node, keep the old one
+        node_ptr tmp_ptr(nullptr, NodeDeleter{&_memory});
+        _lru_tail = _lru_tail->prev;
+        tmp_ptr.swap(_lru_tail != nullptr ? _lru_tail->next : _lru_head);
+        _cur_size = _entries_size();
+        return false;
+    }
+
+    _payload_size += key.size() + value.size();
+    _cache.Added(key.size() + value.size());
+    _strings_size += string_size(_lru_tail->key) + string_size(_lru_tail->value);
+    _account(_lru_tail);
     return true;
 }
 
@@ -151,14 +253,26 @@ bool SimpleLRU::_put(const std::string &key, const std::string &value)
 bool SimpleLRU::_set(back_node_iter elem_iter, const std::string &value)
 {
     lru_node &elem_node = elem_iter->second;
-    int size_dif = value.size() - elem_node.value.size();
+    std::size_t old_payload = elem_node.value.size();
+    std::size_t old_size = string_size(elem_node.value);
+    std::size_t new_size = string_size(value.size());
     bool ret_b = _node_to_tail(elem_node);
-    if (size_dif > 0)
-        if (!_is_free(size_dif))
+    if (new_size > old_size)
+        if (!_is_free(new_size - old_size, &elem_node))
             return false;
 
-    elem_node.value = value;
-    _cur_size += size_dif;
+    _cache.Removed(elem_node.key.size() + old_payload);
+    if (value.size() > elem_node.value.capacity() || string_size(value.size()) < old_size) {
+        // Fresh copy of exact size, so large buffer isn't kept after value shrinks
+        std::string(value).swap(elem_node.value);
+    } else {
+        elem_node.value.assign(value);
+    }
+
+    _payload_size = _payload_size - old_payload + value.size();
+    _cache.Added(elem_node.key.size() + value.size());
+    _strings_size = _strings_size - old_size + string_size(elem_node.value);
+    _account(&elem_node);
     return ret_b;
 }
 
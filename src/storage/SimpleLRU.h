@@ -1,33 +1,52 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <afina/Storage.h>
+#include <afina/allocator/PoolResource.h>
+#include <afina/allocator/StdAllocator.h>
+#include <afina/concurrency/Tsc.h>
+
+#include "CacheStats.h"
 
 namespace Afina {
 namespace Backend {
 
 /*
- * # Map based implementation
+ * # Hash map based implementation
+ * Size limit is enforced against memory really taken by entries: list node, index node and string
+ * buffers, all including allocator rounding, not only key and value lengths.
+ *
  * That is NOT thread safe implementaiton!!
  */
 class SimpleLRU : public Afina::Storage {
 public:
 
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size),
-                                        _cur_size(0),
-                                        _lru_head(nullptr),
-                                        _lru_tail(nullptr) {}
+    /**
+     * @param max_size limit of memory taken by entries, in bytes
+     * @param expected_items number of entries storage is expected to hold, index and memory pools
+     * are sized for it upfront
+     * @param pools where nodes and index come from, process wide pools if nullptr
+     */
+    SimpleLRU(size_t max_size = 1024, size_t expected_items = 0, Allocator::PoolResource *pools = nullptr)
+        : _max_size(max_size), _cur_size(0), _payload_size(0), _strings_size(0),
+          _pools(pools != nullptr ? pools : &Allocator::PoolResource::Default()), _memory(_pools),
+          _lru_head(nullptr, NodeDeleter{&_memory}), _lru_tail(nullptr),
+          _lru_index(0, std::hash<std::string>(), std::equal_to<std::string>(), index_allocator(&_memory)) {
+        _reserve(expected_items);
+    }
 
     ~SimpleLRU() {
         _lru_index.clear();
         if (_lru_head != nullptr) {
             while (_lru_head->next != nullptr) {
-                std::unique_ptr<lru_node> tmp(nullptr);
+                node_ptr tmp(nullptr, NodeDeleter{&_memory});
                 tmp.swap(_lru_head->next);
                 _lru_head.swap(tmp);
                 tmp.reset();
@@ -51,33 +70,78 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    void Stats(std::vector<std::pair<std::string, std::string>> &stats) override;
+
+    // Implements Afina::Storage interface
+    void ForEach(const Visitor &visitor) override;
+
+    // Implements Afina::Storage interface
+    bool Restore(const std::string &key, const std::string &value) override;
+
 private:
+    struct lru_node;
+
+    // Destroys node and gives its memory back to the storage resource
+    struct NodeDeleter {
+        Allocator::MemoryResource *memory;
+
+        void operator()(lru_node *node) const;
+    };
+
+    using node_ptr = std::unique_ptr<lru_node, NodeDeleter>;
+
     // LRU cache node
-    using lru_node = struct lru_node {
+    struct lru_node {
         const std::string key;
         std::string value;
         lru_node *prev;
-        std::unique_ptr<lru_node> next;
+        node_ptr next;
+
+        // TSC time of the last access, to know how long evicted entry stayed unused
+        uint64_t touched;
 
-        lru_node(const std::string& _k, const std::string& _v) :
-            key(_k), value(_v), prev(nullptr), next(nullptr) { }
+        lru_node(const std::string& _k, const std::string& _v, Allocator::MemoryResource *memory) :
+            key(_k), value(_v), prev(nullptr), next(nullptr, NodeDeleter{memory}),
+            touched(Concurrency::Tsc::Now()) { }
     };
 
-    // Maximum number of bytes could be stored in this cache.
-    // i.e all (keys+values) must be less the _max_size
+    // Maximum number of bytes could be taken by this cache, see _cur_size
     std::size_t _max_size;
+
+    // Bytes really taken by entries: nodes and index nodes from _memory plus heap buffers of strings
     std::size_t _cur_size;
 
+    // Sum of keys and values sizes
+    std::size_t _payload_size;
+
+    // Bytes taken by heap buffers of keys and values
+    std::size_t _strings_size;
+
+    // Hits, misses, evictions and entries by size class
+    CacheStats _cache;
+
+    // Size class pools nodes and index are drawn from
+    Allocator::PoolResource *_pools;
+
+    // Memory taken by nodes and index
+    Allocator::CountingResource _memory;
+
     // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
     // element that wasn't used for longest time.
 
     // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head;
+    node_ptr _lru_head;
     lru_node *_lru_tail;
 
-    using back_node = std::map<std::reference_wrapper<const std::string>,
+    using index_allocator = Allocator::StdAllocator<
+             std::pair<const std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>>>;
+
+    using back_node = std::unordered_map<std::reference_wrapper<const std::string>,
              std::reference_wrapper<lru_node>,
-             std::less<std::string>>;
+             std::hash<std::string>,
+             std::equal_to<std::string>,
+             index_allocator>;
 
     // Index of nodes from list above, allows fast random access to elements by lru_node#key
     back_node _lru_index;
@@ -91,7 +155,27 @@ private:
 
     bool _node_to_tail(lru_node &node_ref);
 
-    bool _is_free(size_t need_to_free);
+    // Evicts least recently used entries, except keep, until need bytes are free
+    bool _is_free(size_t need_to_free, const lru_node *keep = nullptr);
+
+    // Evicts least recently used entry
+    void _evict_head();
+
+    // Recomputes _cur_size and evicts entries, except keep, if actual size went above the limit
+    void _account(const lru_node *keep);
+
+    // Bytes taken by bucket table of the index, it depends on expected rather than current number
+    // of entries so doesn't count against the limit
+    std::size_t _table_size() const;
+
+    // Bytes really taken by entries, see _cur_size
+    std::size_t _entries_size() const;
+
+    // Bytes new entry with given sizes would take
+    std::size_t _entry_size(std::size_t key_size, std::size_t value_size) const;
+
+    // Sizes index and memory pools for the given number of entries
+    void _reserve(std::size_t expected_items);
 
     bool _put(const std::string &key, const std::string &value);
 
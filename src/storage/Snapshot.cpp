@@ -0,0 +1,180 @@
+#include "Snapshot.h"
+#include "Encoding.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+const char kMagic[] = "AFSNAP01";
+const std::size_t kMagicSize = sizeof(kMagic) - 1;
+const char kEntry = 'E';
+const char kEnd = 'Z';
+
+std::runtime_error io_error(const std::string &what, const std::string &path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+// Closes file on scope exit
+struct FileCloser {
+    void operator()(FILE *file) const { std::fclose(file); }
+};
+
+} // namespace
+
+// See Snapshot.h
+std::size_t Snapshot::Write(Afina::Storage &storage, const std::string &path) {
+    const std::string tmp_path = path + ".tmp";
+    std::unique_ptr<FILE, FileCloser> file(std::fopen(tmp_path.c_str(), "wb"));
+    if (!file) {
+        throw io_error("Failed to create", tmp_path);
+    }
+    std::setvbuf(file.get(), nullptr, _IOFBF, 1 << 20);
+
+    std::size_t count = 0;
+    uint64_t checksum = kFnvOffset;
+    bool failed = std::fwrite(kMagic, 1, kMagicSize, file.get()) != kMagicSize;
+    storage.ForEach([&](const std::string &key, const std::string &value) {
+        char header[1 + 2 * kMaxVarint];
+        std::size_t size = 0;
+        header[size++] = kEntry;
+        size += put_varint(header + size, key.size());
+        size += put_varint(header + size, value.size());
+
+        checksum = fnv1a(checksum, header, size);
+        checksum = fnv1a(checksum, key.data(), key.size());
+        checksum = fnv1a(checksum, value.data(), value.size());
+
+        failed = failed || std::fwrite(header, 1, size, file.get()) != size ||
+                 std::fwrite(key.data(), 1, key.size(), file.get()) != key.size() ||
+                 std::fwrite(value.data(), 1, value.size(), file.get()) != value.size();
+        count++;
+    });
+
+    uint64_t trailer[2] = {count, checksum};
+    failed = failed || std::fputc(kEnd, file.get()) == EOF ||
+             std::fwrite(trailer, sizeof(trailer), 1, file.get()) != 1 || std::fflush(file.get()) != 0 ||
+             fsync(fileno(file.get())) != 0;
+    if (failed) {
+        int error = errno;
+        unlink(tmp_path.c_str());
+        errno = error;
+        throw io_error("Failed to write", tmp_path);
+    }
+
+    file.reset();
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw io_error("Failed to rename snapshot to", path);
+    }
+    return count;
+}
+
+// See Snapshot.h
+pid_t Snapshot::Fork(Afina::Storage &storage, const std::string &path) {
+    if (!storage.CanQuiesce()) {
+        throw std::runtime_error("Storage can't be quiesced for snapshot " + path);
+    }
+
+    pid_t pid = -1;
+    storage.Quiesce([&storage, &path, &pid]() {
+        pid = fork();
+        if (pid == 0) {
+            // Child has only this thread and a frozen copy of the storage, locks held by the
+            // parent are never released here, so storage is read without them
+            int code = 0;
+            try {
+                Write(storage, path);
+            } catch (std::exception &ex) {
+                std::fprintf(stderr, "Snapshot failed: %s\n", ex.what());
+                code = 1;
+            }
+            _exit(code);
+        }
+    });
+
+    if (pid < 0) {
+        throw io_error("Failed to fork snapshot of", path);
+    }
+    return pid;
+}
+
+// See Snapshot.h
+std::size_t Snapshot::Load(Afina::Storage &storage, const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw io_error("Failed to open", path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw io_error("Failed to stat", path);
+    }
+
+    const std::size_t size = st.st_size;
+    const std::size_t trailer_size = 1 + 2 * sizeof(uint64_t);
+    if (size < kMagicSize + trailer_size) {
+        close(fd);
+        throw std::runtime_error("Snapshot " + path + " is truncated");
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw io_error("Failed to map", path);
+    }
+    std::unique_ptr<void, std::function<void(void *)>> mapping(data, [size](void *p) { munmap(p, size); });
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    const char *begin = static_cast<const char *>(data);
+    const char *body = begin + kMagicSize;
+    const char *end = begin + size - trailer_size;
+    if (std::memcmp(begin, kMagic, kMagicSize) != 0 || *end != kEnd) {
+        throw std::runtime_error("Snapshot " + path + " has bad format");
+    }
+
+    uint64_t trailer[2];
+    std::memcpy(trailer, end + 1, sizeof(trailer));
+    if (fnv1a(kFnvOffset, body, end - body) != trailer[1]) {
+        throw std::runtime_error("Snapshot " + path + " checksum mismatch");
+    }
+
+    // Verify structure first, so that broken file doesn't leave storage half loaded
+    for (int pass = 0; pass < 2; pass++) {
+        std::size_t count = 0;
+        std::string key, value;
+        for (const char *pos = body; pos < end; count++) {
+            uint64_t key_size, value_size;
+            if (*pos++ != kEntry || !get_varint(pos, end, key_size) || !get_varint(pos, end, value_size) ||
+                key_size > std::size_t(end - pos) || value_size > std::size_t(end - pos) - key_size) {
+                throw std::runtime_error("Snapshot " + path + " has broken entry " + std::to_string(count));
+            }
+            if (pass == 1) {
+                key.assign(pos, key_size);
+                value.assign(pos + key_size, value_size);
+                storage.Restore(key, value);
+            }
+            pos += key_size + value_size;
+        }
+        if (count != trailer[0]) {
+            throw std::runtime_error("Snapshot " + path + " has " + std::to_string(count) + " entries instead of " +
+                                     std::to_string(trailer[0]));
+        }
+    }
+    return trailer[0];
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,53 @@
+#ifndef AFINA_STORAGE_SNAPSHOT_H
+#define AFINA_STORAGE_SNAPSHOT_H
+
+#include <cstddef>
+#include <string>
+
+#include <sys/types.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage snapshot file
+ * Binary dump of all entries in LRU order, so that restarted server comes up warm. Layout:
+ *
+ * "AFSNAP01" | { 'E' varint(key size) varint(value size) key value }* | 'Z' u64(count) u64(checksum)
+ *
+ * Sizes are LEB128 varints, checksum is FNV-1a over all entry records. File is written next to the
+ * target and renamed over it once complete, so reader never sees half written snapshot.
+ */
+class Snapshot {
+public:
+    /**
+     * Writes all entries of the storage to the file. Storage must not be modified meanwhile
+     *
+     * @return number of entries written, throws std::runtime_error on IO error
+     */
+    static std::size_t Write(Afina::Storage &storage, const std::string &path);
+
+    /**
+     * Forks child process which writes copy-on-write image of the storage to the file, while
+     * parent goes on serving traffic. Storage is quiesced only for the duration of fork(), storage
+     * which can't be quiesced is refused, as the child could copy it in the middle of a change
+     *
+     * @return pid of the child, exits with 0 on success
+     */
+    static pid_t Fork(Afina::Storage &storage, const std::string &path);
+
+    /**
+     * Loads entries from the file into the storage via Storage::Restore. Whole file is verified
+     * before the first entry gets loaded
+     *
+     * @return number of entries loaded, throws std::runtime_error if file is missing or corrupted
+     */
+    static std::size_t Load(Afina::Storage &storage, const std::string &path);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SNAPSHOT_H
@@ -6,6 +6,8 @@
 #include <string>
 #include <unistd.h>
 
+#include <afina/concurrency/Tsc.h>
+
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -18,8 +20,9 @@ namespace Backend {
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
     public:
-        ThreadSafeSimplLRU(size_t max_size = 1024)
-            : SimpleLRU(max_size)
+        ThreadSafeSimplLRU(size_t max_size = 1024, size_t expected_items = 0,
+                           Allocator::PoolResource *pools = nullptr)
+            : SimpleLRU(max_size, expected_items, pools)
         {
         }
         ~ThreadSafeSimplLRU() {}
@@ -27,41 +30,76 @@ class ThreadSafeSimplLRU : public SimpleLRU {
         // see SimpleLRU.h
         bool Put(const std::string& key, const std::string& value) override
         {
-            std::lock_guard<std::mutex> _lock(_m);
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
             return SimpleLRU::Put(key, value);
         }
 
         // see SimpleLRU.h
         bool PutIfAbsent(const std::string& key, const std::string& value) override
         {
-            std::lock_guard<std::mutex> _lock(_m);
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
             return SimpleLRU::PutIfAbsent(key, value);
         }
 
         // see SimpleLRU.h
         bool Set(const std::string& key, const std::string& value) override
         {
-            std::lock_guard<std::mutex> _lock(_m);
-             sleep(1);
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
             return SimpleLRU::Set(key, value);
         }
 
         // see SimpleLRU.h
         bool Delete(const std::string& key) override
         {
-            std::lock_guard<std::mutex> _lock(_m);
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
             return SimpleLRU::Delete(key);
         }
 
         // see SimpleLRU.h
         bool Get(const std::string& key, std::string& value) override
         {
-            std::lock_guard<std::mutex> _lock(_m);
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
             return SimpleLRU::Get(key, value);
         }
 
+        // see Afina::Storage, all keys are looked up under one lock
+        void GetMany(const std::vector<const std::string *> &keys, std::vector<std::string> &values,
+                     std::vector<bool> &found) override
+        {
+            values.resize(keys.size());
+            found.resize(keys.size());
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
+            for (std::size_t i = 0; i < keys.size(); i++) {
+                found[i] = SimpleLRU::Get(*keys[i], values[i]);
+            }
+        }
+
+        // see SimpleLRU.h
+        void Stats(std::vector<std::pair<std::string, std::string>> &stats) override
+        {
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
+            SimpleLRU::Stats(stats);
+        }
+
+        // see SimpleLRU.h
+        bool Restore(const std::string& key, const std::string& value) override
+        {
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
+            return SimpleLRU::Restore(key, value);
+        }
+
+        // see SimpleLRU.h
+        void Quiesce(const std::function<void()> &f) override
+        {
+            std::lock_guard<Concurrency::TracedMutex> _lock(_m);
+            f();
+        }
+
+        // see SimpleLRU.h
+        bool CanQuiesce() const override { return true; }
+
     private:
-        std::mutex _m;
+        Concurrency::TracedMutex _m;
     };
 
 } // namespace Backend
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Mempool.h>
+#include <afina/allocator/Pages.h>
+#include <afina/allocator/SlabCache.h>
+
+using namespace Afina::Allocator;
+
+TEST(MempoolTest, SlabsAreAligned) {
+    Arena arena(3 * Arena::kSlabSize);
+    std::set<void *> slabs;
+    for (int i = 0; i < 10; i++) {
+        void *slab = arena.Map();
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(slab) % Arena::kSlabSize);
+        EXPECT_TRUE(slabs.insert(slab).second);
+        std::memset(slab, 0xab, Arena::kSlabSize);
+    }
+    EXPECT_GE(arena.Mapped(), 10 * Arena::kSlabSize);
+}
+
+TEST(MempoolTest, HugePagesFallBack) {
+    // Whatever system gives, mapping must be usable and aligned
+    for (PageKind kind : {PageKind::Normal, PageKind::Transparent, PageKind::Huge}) {
+        Mapping mapping(3 * Arena::kSlabSize, Arena::kSlabSize, PagePolicy(kind, true));
+        EXPECT_GE(mapping.size(), 3 * Arena::kSlabSize);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(mapping.data()) % Arena::kSlabSize);
+        EXPECT_LE(int(mapping.kind()), int(kind));
+        std::memset(mapping.data(), 0xab, mapping.size());
+    }
+
+    Arena arena(4 * Arena::kSlabSize);
+    PageKind obtained = arena.SetPolicy(PagePolicy(PageKind::Huge));
+    std::memset(arena.Map(), 0xab, Arena::kSlabSize);
+    EXPECT_EQ(arena.Mapped(), arena.Mapped(obtained));
+}
+
+TEST(MempoolTest, SlabCacheReuses) {
+    Arena arena;
+    SlabCache cache(arena);
+
+    void *a = cache.Get();
+    void *b = cache.Get();
+    EXPECT_NE(a, b);
+
+    cache.Put(a);
+    EXPECT_EQ(1u, cache.Cached());
+    EXPECT_EQ(a, cache.Get());
+    EXPECT_EQ(0u, cache.Cached());
+}
+
+TEST(MempoolTest, AllocFree) {
+    Arena arena;
+    SlabCache slabs(arena);
+    Mempool pool(100, slabs);
+    EXPECT_EQ(0u, pool.ObjectSize() % alignof(std::max_align_t));
+
+    std::set<char *> objects;
+    for (int i = 0; i < 10000; i++) {
+        char *p = static_cast<char *>(pool.Alloc());
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t));
+        std::memset(p, i, 100);
+        EXPECT_TRUE(objects.insert(p).second);
+    }
+
+    std::size_t slabs_used = pool.Slabs();
+    for (char *p : objects) {
+        pool.Free(p);
+    }
+    for (int i = 0; i < 10000; i++) {
+        pool.Alloc();
+    }
+    EXPECT_EQ(slabs_used, pool.Slabs());
+}
+
+TEST(MempoolTest, Concurrent) {
+    Mempool pool(48);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&pool, t]() {
+            std::vector<int *> mine;
+            for (int round = 0; round < 50; round++) {
+                for (int i = 0; i < 500; i++) {
+                    int *p = static_cast<int *>(pool.Alloc());
+                    *p = t;
+                    mine.push_back(p);
+                }
+                for (int *p : mine) {
+                    EXPECT_EQ(t, *p);
+                    pool.Free(p);
+                }
+                mine.clear();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Objects freed by exited threads are back in the depot, so they are reused
+    std::size_t slabs = pool.Slabs();
+    for (int i = 0; i < 1000; i++) {
+        pool.Alloc();
+    }
+    EXPECT_EQ(slabs, pool.Slabs());
+}
+
+TEST(MempoolTest, ShortLivedThreads) {
+    Mempool pool(48);
+
+    // Each thread keeps less than a batch, exit must still give it back
+    for (int t = 0; t < 1000; t++) {
+        std::thread([&pool]() { pool.Free(pool.Alloc()); }).join();
+    }
+    EXPECT_EQ(1u, pool.Slabs());
+}
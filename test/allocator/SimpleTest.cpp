@@ -103,6 +103,16 @@ TEST(SimpleTest, AllocNoMem) {
     }
 }
 
+TEST(SimpleTest, MaxSize) {
+    Simple a(buf, sizeof(buf));
+    size_t max = a.max_size();
+    EXPECT_LT(max, sizeof(buf));
+
+    Pointer p = a.alloc(max);
+    a.free(p);
+    EXPECT_THROW(a.alloc(max + 1), AllocError);
+}
+
 TEST(SimpleTest, AllocReuse) {
     Simple a(buf, sizeof(buf));
 
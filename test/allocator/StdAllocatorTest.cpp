@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <map>
+#include <new>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <afina/allocator/MemoryResource.h>
+#include <afina/allocator/PoolResource.h>
+#include <afina/allocator/StdAllocator.h>
+
+using namespace Afina::Allocator;
+
+TEST(StdAllocatorTest, SizeClasses) {
+    EXPECT_EQ(16u, PoolResource::Rounded(0));
+    EXPECT_EQ(16u, PoolResource::Rounded(1));
+    EXPECT_EQ(32u, PoolResource::Rounded(17));
+    EXPECT_EQ(128u, PoolResource::Rounded(128));
+    EXPECT_EQ(160u, PoolResource::Rounded(129));
+    EXPECT_EQ(4096u, PoolResource::Rounded(4000));
+    EXPECT_EQ(5000u, PoolResource::Rounded(5000));
+}
+
+TEST(StdAllocatorTest, Footprint) {
+    EXPECT_EQ(32u, NewDeleteResource()->footprint(1));
+    EXPECT_EQ(1024u + 16, NewDeleteResource()->footprint(1024));
+    EXPECT_EQ(48u, PoolResource::Default().footprint(33));
+    EXPECT_EQ(NewDeleteResource()->footprint(10000), PoolResource::Default().footprint(10000));
+
+    CountingResource counter(&PoolResource::Default());
+    void *p = counter.allocate(100);
+    EXPECT_EQ(112u, counter.allocated());
+    counter.deallocate(p, 100);
+    EXPECT_EQ(0u, counter.allocated());
+}
+
+TEST(StdAllocatorTest, CountsContainers) {
+    CountingResource counter(&PoolResource::Default());
+    {
+        std::vector<int, StdAllocator<int>> v{StdAllocator<int>(&counter)};
+        for (int i = 0; i < 1000; i++) {
+            v.push_back(i);
+        }
+        EXPECT_GE(counter.allocated(), 1000 * sizeof(int));
+
+        String s{StdAllocator<char>(&counter)};
+        s.assign(10000, 'x');
+        EXPECT_GE(counter.allocated(), 1000 * sizeof(int) + 10000);
+
+        using Map = std::map<int, String, std::less<int>, StdAllocator<std::pair<const int, String>>>;
+        Map m{std::less<int>(), Map::allocator_type(&counter)};
+        for (int i = 0; i < 100; i++) {
+            m.emplace(std::piecewise_construct, std::forward_as_tuple(i),
+                      std::forward_as_tuple(std::string(100, 'a' + i % 26).c_str(), &counter));
+        }
+        EXPECT_EQ(std::string(100, 'a'), m.at(0).c_str());
+
+        Map copy = m;
+        EXPECT_EQ(copy.get_allocator(), m.get_allocator());
+    }
+    EXPECT_EQ(0u, counter.allocated());
+}
+
+TEST(StdAllocatorTest, Limit) {
+    CountingResource counter(NewDeleteResource(), 1024);
+    std::vector<char, StdAllocator<char>> v{StdAllocator<char>(&counter)};
+
+    v.resize(1000);
+    EXPECT_THROW(v.resize(2000), std::bad_alloc);
+    EXPECT_EQ(1000u, v.size());
+    EXPECT_EQ(NewDeleteResource()->footprint(1000), counter.allocated());
+}
+
+TEST(StdAllocatorTest, Equality) {
+    CountingResource a, b;
+    EXPECT_TRUE(StdAllocator<int>(&a) == StdAllocator<long>(&a));
+    EXPECT_TRUE(StdAllocator<int>(&a) != StdAllocator<int>(&b));
+    EXPECT_TRUE(StdAllocator<int>() == StdAllocator<int>(NewDeleteResource()));
+}
@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(CoreLocalTest, OneInstancePerCpu) {
+    CoreLocal<int> cells;
+    ASSERT_EQ(CoreLocal<int>::cpus(), cells.size());
+    ASSERT_LT(CoreLocal<int>::current(), cells.size());
+
+    cells.for_each([](int &v) { v = 1; });
+    EXPECT_EQ(cells.size(), cells.aggregate(std::size_t(0), [](std::size_t sum, int &v) { return sum + v; }));
+
+    cells.local() = 10;
+    EXPECT_EQ(cells.size() + 9, cells.aggregate(std::size_t(0), [](std::size_t sum, int &v) { return sum + v; }));
+}
+
+TEST(CoreLocalTest, CellsDontShareCacheLine) {
+    CoreLocal<char> cells;
+    if (cells.size() < 2) {
+        return;
+    }
+    const char *a = &cells.at(0);
+    const char *b = &cells.at(1);
+    EXPECT_GE(b - a, 64);
+}
+
+TEST(CoreLocalTest, CounterIsZeroInitialized) {
+    CoreCounter counter;
+    EXPECT_EQ(0, counter.Get());
+    counter.Add(5);
+    counter.Add(-2);
+    EXPECT_EQ(3, counter.Get());
+}
+
+TEST(CoreLocalTest, CounterConcurrent) {
+    const int threads = 8;
+    const int increments = 100000;
+
+    CoreCounter counter;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&counter]() {
+            for (int i = 0; i < increments; i++) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    EXPECT_EQ(int64_t(threads) * increments, counter.Get());
+}
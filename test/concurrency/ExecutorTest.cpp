@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+// Blocks pool threads until test opens it
+class Gate {
+public:
+    void Wait() {
+        std::unique_lock<std::mutex> lock(_m);
+        while (!_open) {
+            _cv.wait(lock);
+        }
+    }
+
+    void Open() {
+        std::unique_lock<std::mutex> lock(_m);
+        _open = true;
+        _cv.notify_all();
+    }
+
+private:
+    std::mutex _m;
+    std::condition_variable _cv;
+    bool _open = false;
+};
+
+static void _add(std::atomic<int> &counter, int value) { counter += value; }
+
+TEST(ExecutorTest, NotStarted) {
+    Executor executor("test", 16, 1, 2, 100);
+
+    std::atomic<int> counter(0);
+    EXPECT_FALSE(executor.Execute(_add, std::ref(counter), 1));
+    EXPECT_EQ(Executor::State::kReady, executor.GetState());
+}
+
+TEST(ExecutorTest, ExecuteAll) {
+    std::atomic<int> counter(0);
+    {
+        Executor executor("test", 1024, 2, 4, 100);
+        executor.Start();
+        EXPECT_EQ(2, executor.Threads());
+
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(executor.Execute(_add, std::ref(counter), 1));
+        }
+        executor.Stop(true);
+        EXPECT_EQ(Executor::State::kStopped, executor.GetState());
+        EXPECT_EQ(0, executor.Threads());
+    }
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST(ExecutorTest, GrowToHighWatermark) {
+    Executor executor("test", 16, 1, 4, 100);
+    executor.Start();
+
+    Gate gate;
+    std::atomic<int> started(0);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(executor.Execute([&gate, &started]() {
+            started++;
+            gate.Wait();
+        }));
+
+        // Let the pool pick task up so that next one sees no free threads
+        while (started.load() <= i) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(4, executor.Threads());
+
+    // Can't grow any more, task waits in the queue
+    EXPECT_TRUE(executor.Execute([]() {}));
+    EXPECT_EQ(4, executor.Threads());
+    EXPECT_EQ(1, executor.Queued());
+
+    gate.Open();
+    executor.Stop(true);
+    EXPECT_EQ(0, executor.Queued());
+}
+
+TEST(ExecutorTest, ShrinkWhenIdle) {
+    Executor executor("test", 16, 1, 3, 20);
+    executor.Start();
+
+    Gate gate;
+    std::atomic<int> started(0);
+    for (int i = 0; i < 3; i++) {
+        executor.Execute([&gate, &started]() {
+            started++;
+            gate.Wait();
+        });
+        while (started.load() <= i) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(3, executor.Threads());
+    gate.Open();
+
+    for (int i = 0; i < 100 && executor.Threads() > 1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(1, executor.Threads());
+}
+
+TEST(ExecutorTest, RejectWhenFull) {
+    Executor executor("test", 2, 1, 1, 100);
+    executor.Start();
+
+    Gate gate;
+    std::atomic<bool> started(false);
+    EXPECT_TRUE(executor.Execute([&gate, &started]() {
+        started = true;
+        gate.Wait();
+    }));
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<int> counter(0);
+    EXPECT_TRUE(executor.Execute(_add, std::ref(counter), 1));
+    EXPECT_TRUE(executor.Execute(_add, std::ref(counter), 1));
+    EXPECT_FALSE(executor.Execute(_add, std::ref(counter), 1));
+
+    gate.Open();
+    executor.Stop(true);
+    EXPECT_EQ(2, counter.load());
+}
+
+TEST(ExecutorTest, CallerRunsWhenFull) {
+    Executor executor("test", 1, 1, 1, 100, Executor::Rejection::kCallerRuns);
+    executor.Start();
+
+    Gate gate;
+    std::atomic<bool> started(false);
+    executor.Execute([&gate, &started]() {
+        started = true;
+        gate.Wait();
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+
+    std::thread::id caller = std::this_thread::get_id();
+    std::thread::id runner;
+    EXPECT_TRUE(executor.Execute([]() {}));
+    EXPECT_TRUE(executor.Execute([&runner]() { runner = std::this_thread::get_id(); }));
+    EXPECT_EQ(caller, runner);
+
+    gate.Open();
+    executor.Stop(true);
+}
+
+TEST(ExecutorTest, NoTasksAfterStop) {
+    Executor executor("test", 16, 1, 2, 100);
+    executor.Start();
+    executor.Stop(false);
+
+    EXPECT_FALSE(executor.Execute([]() {}));
+    executor.Stop(true);
+    EXPECT_EQ(Executor::State::kStopped, executor.GetState());
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+
+struct Increment {
+    int delta;
+    long result;
+};
+
+TEST(FlatCombineTest, SingleThread) {
+    long counter = 0;
+    FlatCombine<Increment> fc([&counter](Increment **ops, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            counter += ops[i]->delta;
+            ops[i]->result = counter;
+        }
+    });
+
+    Increment op{5, 0};
+    fc.Execute(op);
+    EXPECT_EQ(5, op.result);
+
+    fc.Execute(op);
+    EXPECT_EQ(10, op.result);
+}
+
+TEST(FlatCombineTest, ManyThreads) {
+    long counter = 0;
+    std::size_t max_batch = 0;
+    FlatCombine<Increment> fc(
+        [&counter, &max_batch](Increment **ops, std::size_t n) {
+            max_batch = std::max(max_batch, n);
+            for (std::size_t i = 0; i < n; i++) {
+                counter += ops[i]->delta;
+                ops[i]->result = counter;
+            }
+        },
+        4);
+
+    // More threads than slots, some of them have to share
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&fc]() {
+            for (int i = 0; i < 10000; i++) {
+                Increment op{1, 0};
+                fc.Execute(op);
+                ASSERT_GT(op.result, 0);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(80000, counter);
+    EXPECT_LE(max_batch, 4);
+}
+
+TEST(FlatCombineTest, CombinerThrows) {
+    long counter = 0;
+    FlatCombine<Increment> fc([&counter](Increment **ops, std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            if (ops[i]->delta < 0) {
+                throw std::invalid_argument("negative delta");
+            }
+            counter += ops[i]->delta;
+            ops[i]->result = counter;
+        }
+    });
+
+    Increment bad{-1, 0};
+    EXPECT_THROW(fc.Execute(bad), std::invalid_argument);
+
+    // Lock and slot are free again
+    Increment good{3, 0};
+    fc.Execute(good);
+    EXPECT_EQ(3, good.result);
+}
@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Histogram.h>
+
+using namespace Afina::Concurrency;
+
+TEST(HistogramTest, BucketsCoverValues) {
+    for (uint64_t v : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, 1ull << 40}) {
+        std::size_t bucket = Histogram::BucketOf(v);
+        ASSERT_LT(bucket, Histogram::kBuckets);
+        EXPECT_LE(Histogram::LowerBound(bucket), v);
+        EXPECT_GE(Histogram::UpperBound(bucket), v);
+        // Relative error is bounded by the number of sub buckets
+        EXPECT_LE(Histogram::UpperBound(bucket) - Histogram::LowerBound(bucket), v / Histogram::kSubBuckets);
+    }
+    EXPECT_EQ(Histogram::kBuckets - 1, Histogram::BucketOf(~0ull));
+}
+
+TEST(HistogramTest, Percentiles) {
+    Histogram histogram;
+    EXPECT_EQ(0u, histogram.Get().Percentile(0.5));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&histogram]() {
+            for (uint64_t v = 1; v <= 1000; v++) {
+                histogram.Record(v * 1000);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    Histogram::Snapshot snapshot = histogram.Get();
+    EXPECT_EQ(4000u, snapshot.count);
+    EXPECT_NEAR(500000.0, snapshot.Percentile(0.5), 500000.0 / Histogram::kSubBuckets);
+    EXPECT_NEAR(990000.0, snapshot.Percentile(0.99), 990000.0 / Histogram::kSubBuckets);
+    EXPECT_GE(snapshot.Max(), 1000000u);
+
+    EXPECT_EQ(4u * 500500u * 1000u, snapshot.sum);
+    EXPECT_EQ(0u, snapshot.CountBelow(999));
+    EXPECT_NEAR(2000.0, snapshot.CountBelow(500000), 2000.0 / Histogram::kSubBuckets);
+    EXPECT_EQ(snapshot.count, snapshot.CountBelow(~0ull));
+}
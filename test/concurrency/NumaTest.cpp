@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+
+#include <set>
+#include <thread>
+
+#include <sched.h>
+
+#include <afina/concurrency/Numa.h>
+
+using namespace Afina::Concurrency;
+
+TEST(NumaTest, DetectCoversAllNodes) {
+    Topology topology = Topology::Detect();
+    ASSERT_GE(topology.Nodes(), 1u);
+    EXPECT_FALSE(topology.IsFake());
+    for (std::size_t i = 0; i < topology.Nodes(); i++) {
+        EXPECT_FALSE(topology.At(i).cpus.empty());
+        EXPECT_GE(topology.At(i).memory, 0);
+    }
+}
+
+TEST(NumaTest, FakeSplitsCpus) {
+    Topology real = Topology::Detect();
+    std::set<int> all;
+    for (std::size_t i = 0; i < real.Nodes(); i++) {
+        all.insert(real.At(i).cpus.begin(), real.At(i).cpus.end());
+    }
+
+    Topology fake = Topology::Fake(3);
+    ASSERT_EQ(3u, fake.Nodes());
+    EXPECT_TRUE(fake.IsFake());
+
+    std::set<int> seen;
+    for (std::size_t i = 0; i < fake.Nodes(); i++) {
+        ASSERT_FALSE(fake.At(i).cpus.empty());
+        seen.insert(fake.At(i).cpus.begin(), fake.At(i).cpus.end());
+    }
+    EXPECT_EQ(all, seen);
+    EXPECT_NE(std::string::npos, fake.Describe().find("3 nodes (fake)"));
+}
+
+TEST(NumaTest, BindRestrictsCpus) {
+    Topology fake = Topology::Fake(2);
+    std::thread t([&fake]() {
+        EXPECT_TRUE(fake.Bind(1));
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        ASSERT_EQ(0, sched_getaffinity(0, sizeof(set), &set));
+        std::set<int> allowed(fake.At(1).cpus.begin(), fake.At(1).cpus.end());
+        EXPECT_EQ(allowed.size(), std::size_t(CPU_COUNT(&set)));
+        for (int cpu : allowed) {
+            EXPECT_TRUE(CPU_ISSET(cpu, &set));
+        }
+    });
+    t.join();
+}
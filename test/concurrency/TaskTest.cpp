@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+#include <afina/concurrency/Task.h>
+
+using namespace Afina::Concurrency;
+
+TEST(TaskTest, Empty) {
+    Task task;
+    EXPECT_FALSE(task);
+    EXPECT_FALSE(task.IsInline());
+}
+
+TEST(TaskTest, SmallClosureInline) {
+    int result = 0;
+    Task task([&result]() { result = 42; });
+    EXPECT_TRUE(task);
+    EXPECT_TRUE(task.IsInline());
+
+    task();
+    EXPECT_EQ(42, result);
+}
+
+TEST(TaskTest, BigClosureOnHeap) {
+    std::array<char, 2 * Task::kInlineSize> payload;
+    payload.fill(7);
+
+    int result = 0;
+    Task task([payload, &result]() { result = payload[0]; });
+    EXPECT_FALSE(task.IsInline());
+
+    task();
+    EXPECT_EQ(7, result);
+}
+
+TEST(TaskTest, MoveOnlyCapture) {
+    std::unique_ptr<int> value(new int(5));
+    int result = 0;
+
+    Task task(std::bind([&result](std::unique_ptr<int> &v) { result = *v; }, std::move(value)));
+    Task other(std::move(task));
+    EXPECT_FALSE(task);
+    EXPECT_TRUE(other);
+
+    other();
+    EXPECT_EQ(5, result);
+}
+
+TEST(TaskTest, DestroysCallable) {
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    {
+        Task task([value]() {});
+        EXPECT_EQ(2, value.use_count());
+
+        Task other;
+        other = std::move(task);
+        EXPECT_EQ(2, value.use_count());
+
+        other.Reset();
+        EXPECT_EQ(1, value.use_count());
+    }
+
+    {
+        std::array<char, 2 * Task::kInlineSize> payload;
+        Task task([value, payload]() {});
+        EXPECT_EQ(2, value.use_count());
+    }
+    EXPECT_EQ(1, value.use_count());
+}
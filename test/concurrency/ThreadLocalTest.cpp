@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(ThreadLocalTest, ValuePerInstance) {
+    ThreadLocal<int> a;
+    ThreadLocal<int> b;
+
+    EXPECT_EQ(0, a.get());
+    a.get() = 1;
+    *b = 2;
+
+    EXPECT_EQ(1, *a);
+    EXPECT_EQ(2, *b);
+    EXPECT_EQ(1u, a.size());
+}
+
+TEST(ThreadLocalTest, ValuePerThread) {
+    ThreadLocal<int> value;
+    *value = -1;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> errors(0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&value, &errors, t]() {
+            if (*value != 0) {
+                errors++;
+            }
+            for (int i = 0; i < 1000; i++) {
+                *value += t;
+            }
+            if (*value != 1000 * t) {
+                errors++;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(0, errors.load());
+    EXPECT_EQ(-1, *value);
+    EXPECT_EQ(1u, value.size());
+}
+
+TEST(ThreadLocalTest, ExitHookAndEnumeration) {
+    std::atomic<long> exited(0);
+    ThreadLocal<std::atomic<long>> counter([&exited](std::atomic<long> &v) { exited += v.load(); });
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> finish(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            *counter += 10;
+            ready++;
+            while (!finish.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (ready.load() < 4) {
+        std::this_thread::yield();
+    }
+
+    long live = 0;
+    counter.for_each([&live](std::atomic<long> &v) { live += v.load(); });
+    EXPECT_EQ(40, live);
+    EXPECT_EQ(4u, counter.size());
+
+    finish.store(true);
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(40, exited.load());
+    EXPECT_EQ(0u, counter.size());
+}
+
+TEST(ThreadLocalTest, DestroyedBeforeThreads) {
+    std::atomic<bool> finish(false);
+    std::atomic<bool> ready(false);
+    ThreadLocal<std::vector<int>> *values = new ThreadLocal<std::vector<int>>();
+
+    std::thread t([&]() {
+        values->get().push_back(1);
+        ready.store(true);
+        while (!finish.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!ready.load()) {
+        std::this_thread::yield();
+    }
+
+    delete values;
+    finish.store(true);
+    t.join();
+}
+
+TEST(ThreadLocalTest, MoreInstancesThanPthreadKeys) {
+    const std::size_t count = 4 * PTHREAD_KEYS_MAX;
+    std::vector<std::unique_ptr<ThreadLocal<std::size_t>>> values;
+    for (std::size_t i = 0; i < count; i++) {
+        values.emplace_back(new ThreadLocal<std::size_t>());
+        values.back()->get() = i;
+    }
+
+    std::thread t([&values, count]() {
+        for (std::size_t i = 0; i < count; i++) {
+            ASSERT_EQ(0u, values[i]->get());
+            values[i]->get() = count - i;
+        }
+    });
+    t.join();
+
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_EQ(i, values[i]->get());
+        EXPECT_EQ(1u, values[i]->size());
+    }
+}
+
+TEST(ThreadLocalTest, ReusedIdStartsEmpty) {
+    std::atomic<bool> finish(false);
+    std::atomic<bool> ready(false);
+    ThreadLocal<int> *first = new ThreadLocal<int>();
+    ThreadLocal<int> *second = nullptr;
+
+    std::thread t([&]() {
+        first->get() = 1;
+        ready.store(true);
+        while (!finish.load()) {
+            std::this_thread::yield();
+        }
+        // Instance most likely got the id of the first one, its old cell must be clear
+        EXPECT_EQ(0, second->get());
+    });
+    while (!ready.load()) {
+        std::this_thread::yield();
+    }
+
+    delete first;
+    second = new ThreadLocal<int>();
+    finish.store(true);
+    t.join();
+
+    EXPECT_EQ(0u, second->size());
+    delete second;
+}
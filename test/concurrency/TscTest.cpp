@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Tsc.h>
+
+using namespace Afina::Concurrency;
+
+TEST(TscTest, Calibrated) {
+    auto started = std::chrono::steady_clock::now();
+    uint64_t ticks = Tsc::Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t nanos = Tsc::ToNanos(Tsc::Now() - ticks);
+    uint64_t expected =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+
+    EXPECT_GE(nanos, expected / 2);
+    EXPECT_LE(nanos, expected * 2);
+}
+
+TEST(TscTest, LockWait) {
+    TracedMutex mutex;
+
+    // Free mutex costs nothing to wait for, accounting is off outside of Begin/End
+    LockWait::Begin();
+    { std::lock_guard<TracedMutex> lock(mutex); }
+    EXPECT_LT(Tsc::ToNanos(LockWait::End()), 1000000u);
+    EXPECT_FALSE(LockWait::Enabled());
+
+    std::unique_lock<TracedMutex> held(mutex);
+    std::thread waiter([&mutex]() {
+        LockWait::Begin();
+        { std::lock_guard<TracedMutex> lock(mutex); }
+        EXPECT_GE(Tsc::ToNanos(LockWait::End()), 10000000u);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    held.unlock();
+    waiter.join();
+}
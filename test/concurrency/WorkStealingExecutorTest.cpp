@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+#include <afina/concurrency/WorkStealingExecutor.h>
+
+using namespace Afina::Concurrency;
+
+static void _add(std::atomic<int> &counter, int value) { counter += value; }
+
+TEST(WorkStealingExecutorTest, NotStarted) {
+    WorkStealingExecutor executor("test", 2);
+
+    std::atomic<int> counter(0);
+    EXPECT_FALSE(executor.Execute(_add, std::ref(counter), 1));
+}
+
+TEST(WorkStealingExecutorTest, ExecuteAll) {
+    std::atomic<int> counter(0);
+    {
+        WorkStealingExecutor executor("test", 4);
+        executor.Start();
+        for (int i = 0; i < 10000; i++) {
+            EXPECT_TRUE(executor.Execute(_add, std::ref(counter), 1));
+        }
+        executor.Stop(true);
+    }
+    EXPECT_EQ(10000, counter.load());
+}
+
+// Every task spawns two children until given depth, all of them lands in local deques
+// and gets spread across workers by stealing
+static void _fanout(WorkStealingExecutor &executor, std::atomic<int> &counter, int depth) {
+    counter++;
+    if (depth > 0) {
+        executor.Execute(_fanout, std::ref(executor), std::ref(counter), depth - 1);
+        executor.Execute(_fanout, std::ref(executor), std::ref(counter), depth - 1);
+    }
+}
+
+TEST(WorkStealingExecutorTest, FanOut) {
+    std::atomic<int> counter(0);
+    WorkStealingExecutor executor("test", 4);
+    executor.Start();
+    executor.Execute(_fanout, std::ref(executor), std::ref(counter), 14);
+
+    // Stop doesn't allow new tasks, so wait for the whole tree first
+    while (counter.load() < (1 << 15) - 1) {
+        std::this_thread::yield();
+    }
+    executor.Stop(true);
+    EXPECT_EQ((1 << 15) - 1, counter.load());
+}
+
+TEST(WorkStealingExecutorTest, NoTasksAfterStop) {
+    WorkStealingExecutor executor("test", 2);
+    executor.Start();
+    executor.Stop(true);
+
+    EXPECT_FALSE(executor.Execute([]() {}));
+}
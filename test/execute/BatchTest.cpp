@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Batch.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Stats.h>
+
+#include "storage/ShardedStorage.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Execute;
+
+class Broken : public Command {
+public:
+    void Execute(Afina::Storage &storage, const std::string &args, std::string &out) override {
+        throw std::runtime_error("broken");
+    }
+};
+
+static void add(Batch &batch, Command *command, const std::string &name, std::string args = "") {
+    RequestTrace trace;
+    batch.Add(std::unique_ptr<Command>(command), name, args, trace);
+    EXPECT_TRUE(args.empty());
+}
+
+TEST(BatchTest, KeepsOrder) {
+    std::vector<std::shared_ptr<Afina::Storage>> shards;
+    for (int i = 0; i < 4; i++) {
+        shards.push_back(std::make_shared<Afina::Backend::SimpleLRU>(1 << 20));
+    }
+    Afina::Backend::ShardedStorage storage(shards);
+
+    Batch batch;
+    add(batch, new Set("a", 0, 0), "set", "1");
+    add(batch, new Get({"a", "b"}), "get");
+    add(batch, new Set("b", 0, 0), "set", "22");
+    add(batch, new Get({"b", "c"}), "get");
+    add(batch, new Get({"a"}), "get");
+    EXPECT_EQ(5u, batch.Size());
+
+    std::string out;
+    std::vector<std::size_t> sizes;
+    batch.Execute(storage, out, [&sizes](RequestTrace &trace, std::size_t size) { sizes.push_back(size); });
+    EXPECT_TRUE(batch.Empty());
+
+    const std::vector<std::string> responses = {"STORED\r\n", "VALUE a 0 1\r\n1\r\nEND\r\n", "STORED\r\n",
+                                                "VALUE b 0 2\r\n22\r\nEND\r\n", "VALUE a 0 1\r\n1\r\nEND\r\n"};
+    std::string expected;
+    ASSERT_EQ(responses.size(), sizes.size());
+    for (std::size_t i = 0; i < responses.size(); i++) {
+        expected += responses[i];
+        EXPECT_EQ(responses[i].size(), sizes[i]);
+    }
+    EXPECT_EQ(expected, out);
+}
+
+TEST(BatchTest, RefusedValueIsError) {
+    Afina::Backend::SimpleLRU storage(1024);
+
+    Batch batch;
+    add(batch, new Set("a", 0, 0), "set", std::string(2048, 'x'));
+    add(batch, new Set("b", 0, 0), "set", "1");
+
+    std::string out;
+    batch.Execute(storage, out, [](RequestTrace &trace, std::size_t size) {});
+    EXPECT_EQ("SERVER_ERROR failed to store object\r\nSTORED\r\n", out);
+}
+
+TEST(BatchTest, FailedCommandKeepsOthers) {
+    Afina::Backend::SimpleLRU storage(1 << 20);
+
+    Batch batch;
+    add(batch, new Set("a", 0, 0), "set", "1");
+    add(batch, new Stats({"foo"}), "stats");
+    add(batch, new Get({"a"}), "get");
+
+    std::string out;
+    std::size_t done = 0;
+    batch.Execute(storage, out, [&done](RequestTrace &trace, std::size_t size) { done++; });
+    EXPECT_EQ(3u, done);
+    EXPECT_EQ("STORED\r\nCLIENT_ERROR unknown stats group\r\nVALUE a 0 1\r\n1\r\nEND\r\n", out);
+}
+
+TEST(BatchTest, ThrowingCommandKeepsOthers) {
+    Afina::Backend::SimpleLRU storage(1 << 20);
+
+    Batch batch;
+    add(batch, new Set("a", 0, 0), "set", "1");
+    add(batch, new Broken(), "broken");
+    add(batch, new Get({"a"}), "get");
+
+    std::string out;
+    batch.Execute(storage, out, [](RequestTrace &trace, std::size_t size) {});
+    EXPECT_EQ("STORED\r\nSERVER_ERROR broken\r\nVALUE a 0 1\r\n1\r\nEND\r\n", out);
+}
+
+TEST(BatchTest, ShardedGetMany) {
+    std::vector<std::shared_ptr<Afina::Storage>> shards;
+    for (int i = 0; i < 4; i++) {
+        shards.push_back(std::make_shared<Afina::Backend::SimpleLRU>(1 << 20));
+    }
+    Afina::Backend::ShardedStorage storage(shards);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) {
+        names.push_back("key" + std::to_string(i));
+        if (i % 3 != 0) {
+            storage.Put(names.back(), "value" + std::to_string(i));
+        }
+    }
+
+    std::vector<const std::string *> keys;
+    for (auto &name : names) {
+        keys.push_back(&name);
+    }
+    std::vector<std::string> values;
+    std::vector<bool> found;
+    storage.GetMany(keys, values, found);
+
+    ASSERT_EQ(names.size(), values.size());
+    ASSERT_EQ(names.size(), found.size());
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i % 3 != 0, found[i]);
+        if (found[i]) {
+            EXPECT_EQ("value" + std::to_string(i), values[i]);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/execute/HotKeys.h>
+
+using namespace Afina::Execute;
+
+TEST(HotKeysTest, FindsHeavyHitter) {
+    TopK sketch(8);
+    // One key takes 30% of the stream, the rest are all distinct
+    for (int i = 0; i < 10000; i++) {
+        if (i % 10 < 3) {
+            sketch.Add("hot");
+        } else {
+            sketch.Add("cold" + std::to_string(i));
+        }
+    }
+
+    std::vector<TopK::Entry> top = sketch.Top(1);
+    ASSERT_EQ(1u, top.size());
+    EXPECT_EQ("hot", top[0].key);
+    EXPECT_GE(top[0].count, 3000u);
+    EXPECT_LE(top[0].count - top[0].error, 3000u);
+    EXPECT_EQ(10000u, sketch.Total());
+}
+
+TEST(HotKeysTest, Merge) {
+    TopK a(4), b(4);
+    for (int i = 0; i < 100; i++) {
+        a.Add("x");
+        b.Add("x");
+        b.Add("y");
+    }
+    a.Merge(b);
+
+    std::vector<TopK::Entry> top = a.Top(2);
+    ASSERT_EQ(2u, top.size());
+    EXPECT_EQ("x", top[0].key);
+    EXPECT_EQ(200u, top[0].count);
+    EXPECT_EQ("y", top[1].key);
+    EXPECT_EQ(300u, a.Total());
+}
+
+TEST(HotKeysTest, Threads) {
+    HotKeys &hot = HotKeys::Default();
+    hot.Configure(16, 1);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&hot, t]() {
+            for (int i = 0; i < 1000; i++) {
+                hot.Touch(i % 2 == 0 ? "hot" : "k" + std::to_string(t * 1000 + i));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Sketches of exited threads are kept
+    std::vector<std::pair<std::string, std::string>> stats;
+    hot.Stats(stats, 1);
+    ASSERT_EQ(3u, stats.size());
+    EXPECT_EQ("4000", stats[1].second);
+    EXPECT_EQ("hotkey:hot", stats[2].first);
+
+    hot.Configure(16, 0);
+}
@@ -0,0 +1,24 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <afina/execute/Stats.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Execute;
+
+TEST(StatsTest, General) {
+    Afina::Backend::SimpleLRU storage(1 << 20);
+    std::string out;
+    Stats().Execute(storage, "", out);
+    EXPECT_EQ(0u, out.find("STAT "));
+    EXPECT_EQ("END", out.substr(out.size() - 3));
+}
+
+TEST(StatsTest, UnknownGroup) {
+    Afina::Backend::SimpleLRU storage(1 << 20);
+    std::string out = "garbage";
+    Stats({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("CLIENT_ERROR unknown stats group", out);
+}
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include <afina/network/Limits.h>
+
+using namespace Afina::Network;
+
+TEST(LimitsTest, Checks) {
+    Limits limits;
+    limits.max_item = 100;
+    limits.max_input = 10;
+    limits.max_output = 1000;
+    ConnectionMemory memory(limits);
+    ConnectionGuard guard(memory);
+
+    EXPECT_NO_THROW(guard.Item(100));
+    EXPECT_THROW(guard.Item(101), LimitExceeded);
+    EXPECT_NO_THROW(guard.Line(10));
+    EXPECT_THROW(guard.Line(11), LimitExceeded);
+    EXPECT_FALSE(guard.Paused(999));
+    EXPECT_TRUE(guard.Paused(1000));
+
+    // Zero turns limit off
+    Limits off;
+    off.max_item = off.max_input = off.max_output = off.max_memory = 0;
+    ConnectionMemory unlimited(off);
+    ConnectionGuard free(unlimited);
+    EXPECT_NO_THROW(free.Item(4000000000u));
+    EXPECT_FALSE(free.Paused(4000000000u));
+}
+
+TEST(LimitsTest, SharedMemory) {
+    Limits limits;
+    limits.max_memory = 4 * ConnectionMemory::kStep;
+    ConnectionMemory memory(limits);
+
+    std::unique_ptr<ConnectionGuard> first(new ConnectionGuard(memory));
+    ConnectionGuard second(memory);
+    EXPECT_EQ(2 * ConnectionMemory::kStep, memory.Used());
+
+    // Small buffers fit into the first step
+    first->Use(100);
+    EXPECT_EQ(2 * ConnectionMemory::kStep, memory.Used());
+
+    // Growth over the budget is refused, memory taken before stays
+    first->Use(ConnectionMemory::kStep);
+    EXPECT_THROW(second.Use(2 * ConnectionMemory::kStep), LimitExceeded);
+    EXPECT_EQ(3 * ConnectionMemory::kStep, memory.Used());
+    EXPECT_EQ(1u, memory.Rejected());
+
+    first->Use(0);
+    EXPECT_NO_THROW(second.Use(2 * ConnectionMemory::kStep));
+    EXPECT_THROW(ConnectionGuard third(memory), LimitExceeded);
+
+    // Closed connection gives everything back
+    first.reset();
+    EXPECT_EQ(3 * ConnectionMemory::kStep, memory.Used());
+    EXPECT_NO_THROW(ConnectionGuard third(memory));
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+
+#include <afina/network/OutputBuffer.h>
+
+using namespace Afina::Network;
+
+// Takes up to size bytes out of the buffer the way writev would
+static std::string send(OutputBuffer &buffer, std::size_t size) {
+    struct iovec iov[4];
+    int count = buffer.Prepare(iov, 4);
+
+    std::string sent;
+    for (int i = 0; i < count && sent.size() < size; i++) {
+        std::size_t part = std::min(size - sent.size(), iov[i].iov_len);
+        sent.append(static_cast<char *>(iov[i].iov_base), part);
+    }
+    buffer.Consume(sent.size());
+    return sent;
+}
+
+TEST(OutputBufferTest, KeepsOrder) {
+    OutputBuffer buffer;
+    EXPECT_TRUE(buffer.Empty());
+
+    std::string expected;
+    for (int i = 0; i < 1000; i++) {
+        std::string response = "VALUE key" + std::to_string(i) + " 0 1\r\nx\r\nEND\r\n";
+        buffer.Append(response);
+        expected += response;
+    }
+    EXPECT_EQ(expected.size(), buffer.Size());
+
+    // Partial writes of odd sizes cross chunk boundaries
+    std::string received;
+    while (!buffer.Empty()) {
+        received += send(buffer, 1000);
+    }
+    EXPECT_EQ(expected, received);
+}
+
+TEST(OutputBufferTest, LargeResponse) {
+    OutputBuffer buffer;
+    std::string value(3 * OutputBuffer::kChunkSize + 17, 'v');
+    buffer.Append(value);
+    buffer.Append("END\r\n");
+
+    // Only as many iovecs as available are filled
+    struct iovec iov[2];
+    EXPECT_EQ(2, buffer.Prepare(iov, 2));
+
+    std::string received;
+    while (!buffer.Empty()) {
+        received += send(buffer, OutputBuffer::kChunkSize / 3);
+    }
+    EXPECT_EQ(value + "END\r\n", received);
+
+    // Buffer is reusable once drained
+    buffer.Append("STORED\r\n");
+    EXPECT_EQ("STORED\r\n", send(buffer, 100));
+    EXPECT_TRUE(buffer.Empty());
+}
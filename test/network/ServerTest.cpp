@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <afina/logging/Service.h>
+#include <afina/network/Server.h>
+
+#include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_blocking/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina::Network;
+
+namespace {
+
+// Drops all messages
+class Silent : public Afina::Logging::Service {
+public:
+    void Start() override {}
+    void Stop() override {}
+    std::shared_ptr<spdlog::logger> select(const std::string &name) noexcept override {
+        return std::make_shared<spdlog::logger>(name, std::make_shared<spdlog::sinks::null_sink_mt>());
+    }
+    std::unique_ptr<spdlog::logger> create(const std::string &name,
+                                           const std::map<std::string, std::string> &mdc) noexcept override {
+        return std::unique_ptr<spdlog::logger>(
+            new spdlog::logger(name, std::make_shared<spdlog::sinks::null_sink_mt>()));
+    }
+    void reopen_all() override {}
+};
+
+std::string stat(Server &server, const std::string &name) {
+    std::vector<std::pair<std::string, std::string>> stats;
+    server.Stats(stats);
+    for (auto &stat : stats) {
+        if (stat.first == name) {
+            return stat.second;
+        }
+    }
+    return "";
+}
+
+// Blocking client of the server on localhost
+class Client {
+public:
+    explicit Client(uint16_t port) : _socket(socket(AF_INET, SOCK_STREAM, 0)) {
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (_socket < 0 || connect(_socket, (struct sockaddr *)&address, sizeof(address)) != 0) {
+            throw std::runtime_error("Failed to connect");
+        }
+    }
+    ~Client() { close(_socket); }
+
+    void Send(const std::string &data) {
+        for (std::size_t sent = 0; sent < data.size();) {
+            ssize_t n = write(_socket, data.data() + sent, data.size() - sent);
+            if (n <= 0) {
+                throw std::runtime_error("Failed to send");
+            }
+            sent += n;
+        }
+    }
+
+    // Reads until given number of bytes arrive or server closes connection
+    std::string Receive(std::size_t size) {
+        std::string data(size, '\0');
+        std::size_t received = 0;
+        while (received < size) {
+            ssize_t n = read(_socket, &data[received], size - received);
+            if (n <= 0) {
+                break;
+            }
+            received += n;
+        }
+        data.resize(received);
+        return data;
+    }
+
+private:
+    int _socket;
+};
+
+// Waits for the server to close all connections, client closes first so that server port is free
+// right after the test
+void drain(Server &server) {
+    for (int i = 0; i < 1000 && stat(server, "connection_memory_bytes") != "0"; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ("0", stat(server, "connection_memory_bytes"));
+}
+
+// Sends data block of the given size and checks that connection keeps just the first step of memory
+// once command is done, then closes the connection
+void large_set(Server &server, uint16_t port, std::size_t size) {
+    const std::string value(size, 'x');
+    {
+        Client client(port);
+        client.Send("set a 0 0 " + std::to_string(size) + "\r\n" + value + "\r\n");
+        EXPECT_EQ("STORED\r\n", client.Receive(8));
+        client.Send("set b 0 0 1\r\ny\r\n");
+        EXPECT_EQ("STORED\r\n", client.Receive(8));
+
+        const std::string step = std::to_string(ConnectionMemory::kStep);
+        for (int i = 0; i < 1000 && stat(server, "connection_memory_bytes") != step; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(step, stat(server, "connection_memory_bytes"));
+    }
+    drain(server);
+}
+
+} // namespace
+
+TEST(ServerTest, LargeArgumentReleased) {
+    auto storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(4 << 20);
+    auto logging = std::make_shared<Silent>();
+    const std::size_t size = 512 * 1024;
+
+    {
+        STblocking::ServerImpl server(storage, logging);
+        server.Start(18092, 1, 1);
+        large_set(server, 18092, size);
+        server.Stop();
+        server.Join();
+    }
+    {
+        MTblocking::ServerImpl server(storage, logging);
+        server.Start(18093, 1, 2);
+        large_set(server, 18093, size);
+        server.Stop();
+        server.Join();
+    }
+    {
+        STnonblock::ServerImpl server(storage, logging);
+        server.Start(18094, 1, 1);
+        large_set(server, 18094, size);
+        server.Stop();
+        server.Join();
+    }
+    {
+        MTnonblock::ServerImpl server(storage, logging);
+        server.Start(18095, 1, 1);
+        large_set(server, 18095, size);
+        server.Stop();
+        server.Join();
+    }
+}
+
+TEST(ServerTest, PausedPipelineOfLargeGets) {
+    Limits limits;
+    limits.max_output = 64 * 1024;
+    limits.max_memory = 8 * ConnectionMemory::kStep;
+
+    auto storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(1 << 20);
+    MTnonblock::ServerImpl server(storage, std::make_shared<Silent>());
+    server.SetLimits(limits);
+    server.Start(18091, 1, 1);
+
+    const std::string value(4096, 'x');
+    // Data block is stored along with its terminator
+    const std::string reply = "VALUE a 0 4098\r\n" + value + "\r\n\r\nEND\r\n";
+    const int gets = 200;
+    {
+        Client client(18091);
+        client.Send("set a 0 0 4096\r\n" + value + "\r\n");
+        EXPECT_EQ("STORED\r\n", client.Receive(8));
+
+        // All of the responses together are well above the memory given to connections
+        std::string requests;
+        for (int i = 0; i < gets; i++) {
+            requests += "get a\r\n";
+        }
+        client.Send(requests);
+
+        std::string responses = client.Receive(reply.size() * gets);
+        EXPECT_EQ(reply.size() * gets, responses.size());
+        for (int i = 0; i < gets && responses.size() >= reply.size() * (i + 1); i++) {
+            EXPECT_EQ(reply, responses.substr(reply.size() * i, reply.size())) << "response " << i;
+        }
+    }
+    drain(server);
+    EXPECT_EQ("0", stat(server, "connections_rejected"));
+
+    server.Stop();
+    server.Join();
+}
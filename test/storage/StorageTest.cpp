@@ -1,16 +1,34 @@
 #include "gtest/gtest.h"
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <set>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/FlatCombineLRU.h"
+#include "storage/HotCache.h"
+#include "storage/Journal.h"
+#include "storage/LoggedStorage.h"
+#include "storage/MappedStorage.h"
+#include "storage/RegionLRU.h"
+#include "storage/ShardedStorage.h"
 #include "storage/SimpleLRU.h"
+#include "storage/Snapshot.h"
+#include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -58,9 +76,28 @@ std::string pad_space(const std::string &s, size_t length) {
     return result;
 }
 
+// Value of the statistics reported by storage
+static size_t stat(Afina::Storage &storage, const std::string &name) {
+    std::vector<std::pair<std::string, std::string>> stats;
+    storage.Stats(stats);
+    for (auto &s : stats) {
+        if (s.first == name) {
+            return std::stoul(s.second);
+        }
+    }
+    return 0;
+}
+
+// Memory taken by one entry with key and value of the given length
+static size_t entry_size(size_t length) {
+    SimpleLRU probe(1 << 20);
+    probe.Put(pad_space("Key", length), pad_space("Val", length));
+    return stat(probe, "bytes");
+}
+
 TEST(StorageTest, BigTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 100000 * length);
+    SimpleLRU storage(100000 * entry_size(length));
 
     for (long i = 0; i < 100000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
@@ -81,7 +118,7 @@ TEST(StorageTest, BigTest) {
 
 TEST(StorageTest, MaxTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 1000 * length);
+    SimpleLRU storage(1000 * entry_size(length));
 
     std::stringstream ss;
 
@@ -108,3 +145,599 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, FlatCombineConcurrent) {
+    const size_t length = 20;
+    FlatCombineLRU storage(4 * 1000 * entry_size(length));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, t, length]() {
+            for (long i = 0; i < 1000; ++i) {
+                auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+                auto val = pad_space("Val " + std::to_string(i), length);
+                EXPECT_TRUE(storage.Put(key, val));
+
+                std::string res;
+                EXPECT_TRUE(storage.Get(key, res));
+                EXPECT_EQ(val, res);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < 4; t++) {
+        for (long i = 0; i < 1000; ++i) {
+            auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+            std::string res;
+            EXPECT_TRUE(storage.Get(key, res));
+            EXPECT_EQ(pad_space("Val " + std::to_string(i), length), res);
+        }
+    }
+}
+
+TEST(StorageTest, FlatCombineRethrowsOwnError) {
+    FlatCombineLRU storage(1024);
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    EXPECT_THROW(storage.Quiesce([]() { throw std::runtime_error("quiesce"); }), std::runtime_error);
+
+    // Combiner lock is released, storage keeps working
+    std::string res;
+    EXPECT_TRUE(storage.Get("KEY1", res));
+    EXPECT_EQ("val1", res);
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+}
+
+TEST(StorageTest, MemoryAccounting) {
+    const size_t limit = 64 * 1024;
+    SimpleLRU storage(limit);
+
+    for (long i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(storage.Put("K" + std::to_string(i), std::string(i % 100, 'v')));
+        ASSERT_LE(stat(storage, "bytes"), limit);
+    }
+
+    // Node, index and string headers dominate for small entries
+    EXPECT_GT(stat(storage, "bytes"), 2 * stat(storage, "payload_bytes"));
+    EXPECT_EQ(limit, stat(storage, "limit_maxbytes"));
+
+    size_t items = stat(storage, "curr_items");
+    EXPECT_TRUE(storage.Put("K9999", std::string(1000, 'v')));
+    EXPECT_LT(stat(storage, "curr_items"), items);
+    ASSERT_LE(stat(storage, "bytes"), limit);
+
+    for (long i = 0; i < 10000; ++i) {
+        storage.Delete("K" + std::to_string(i));
+    }
+    EXPECT_EQ(0u, stat(storage, "bytes"));
+    EXPECT_EQ(0u, stat(storage, "payload_bytes"));
+}
+
+TEST(StorageTest, CacheStats) {
+    SimpleLRU storage(16 * 1024);
+    std::string value;
+
+    EXPECT_TRUE(storage.Put("small", "v"));
+    EXPECT_TRUE(storage.Put("large", std::string(1000, 'v')));
+    EXPECT_TRUE(storage.Get("small", value));
+    EXPECT_FALSE(storage.Get("none", value));
+    EXPECT_EQ(1u, stat(storage, "lookup_hits"));
+    EXPECT_EQ(1u, stat(storage, "lookup_misses"));
+    EXPECT_EQ(1u, stat(storage, "class_64_items"));
+    EXPECT_EQ(6u, stat(storage, "class_64_bytes"));
+    EXPECT_EQ(1u, stat(storage, "class_1024_items"));
+
+    // Value grows into the next class
+    EXPECT_TRUE(storage.Set("small", std::string(100, 'v')));
+    EXPECT_EQ(0u, stat(storage, "class_64_items"));
+    EXPECT_EQ(1u, stat(storage, "class_256_items"));
+
+    // Every eviction gets its idle time, fresh entries are all below a second
+    for (long i = 0; i < 1000; ++i) {
+        storage.Put("K" + std::to_string(i), std::string(100, 'v'));
+    }
+    EXPECT_GT(stat(storage, "evictions"), 0u);
+    EXPECT_EQ(stat(storage, "evictions"), stat(storage, "evicted_idle_1s"));
+    EXPECT_EQ(stat(storage, "curr_items"),
+              stat(storage, "class_64_items") + stat(storage, "class_256_items") + stat(storage, "class_1024_items"));
+
+    storage.Delete("K999");
+    EXPECT_EQ(stat(storage, "curr_items"),
+              stat(storage, "class_64_items") + stat(storage, "class_256_items") + stat(storage, "class_1024_items"));
+}
+
+TEST(StorageTest, RegionPutGet) {
+    RegionLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", ""));
+    EXPECT_TRUE(storage.Put("KEY1", "longer val1"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("longer val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Put("KEY4", std::string(2048, 'x')));
+}
+
+TEST(StorageTest, RegionEvictsOldest) {
+    const size_t length = 64;
+    RegionLRU storage(100 * 2 * length);
+
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), pad_space("Val " + std::to_string(i), length)));
+    }
+
+    std::string res;
+    EXPECT_FALSE(storage.Get("Key 0", res));
+    for (long i = 990; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Get("Key " + std::to_string(i), res));
+        EXPECT_EQ(pad_space("Val " + std::to_string(i), length), res);
+    }
+}
+
+TEST(StorageTest, RegionRejectsOversizedUpFront) {
+    RegionLRU storage(4096);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Val " + std::to_string(i)));
+    }
+
+    EXPECT_FALSE(storage.Put("Huge", std::string(4096, 'x')));
+    EXPECT_FALSE(storage.Set("Key 0", std::string(4096, 'x')));
+    EXPECT_EQ(10, stat(storage, "curr_items"));
+
+    std::string res;
+    EXPECT_TRUE(storage.Get("Key 0", res));
+    EXPECT_EQ("Val 0", res);
+}
+
+TEST(StorageTest, RegionChurn) {
+    RegionLRU storage(64 * 1024);
+    std::map<std::string, std::string> expected;
+
+    // Values of different sizes in random order fragment the region, storage must compact it
+    // instead of throwing away entries while there is enough free space
+    unsigned seed = 1;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        std::string key = "Key " + std::to_string(seed % 64);
+        std::string val(16 + (seed >> 8) % 512, char('a' + i % 26));
+
+        EXPECT_TRUE(storage.Put(key, val));
+        expected[key] = val;
+    }
+
+    for (auto &kv : expected) {
+        std::string res;
+        EXPECT_TRUE(storage.Get(kv.first, res));
+        EXPECT_EQ(kv.second, res);
+    }
+}
+
+TEST(StorageTest, ShardedPutGet) {
+    std::vector<std::shared_ptr<Afina::Storage>> shards;
+    for (int i = 0; i < 4; i++) {
+        shards.push_back(std::make_shared<SimpleLRU>(1 << 20, 64));
+    }
+    ShardedStorage storage(shards);
+
+    for (int i = 0; i < 200; i++) {
+        EXPECT_TRUE(storage.Put("key" + std::to_string(i), "val" + std::to_string(i)));
+    }
+    EXPECT_FALSE(storage.PutIfAbsent("key0", "other"));
+    EXPECT_TRUE(storage.Delete("key1"));
+
+    std::string value;
+    for (int i = 2; i < 200; i++) {
+        ASSERT_TRUE(storage.Get("key" + std::to_string(i), value));
+        EXPECT_EQ(value, "val" + std::to_string(i));
+    }
+    EXPECT_FALSE(storage.Get("key1", value));
+
+    // Every shard got some keys and counters are summed up
+    for (auto &shard : shards) {
+        EXPECT_GT(stat(*shard, "curr_items"), 0u);
+    }
+    EXPECT_EQ(stat(storage, "curr_items"), 199u);
+    EXPECT_EQ(stat(storage, "limit_maxbytes"), size_t(4 << 20));
+}
+
+TEST(StorageTest, ShardedNodeOf) {
+    std::vector<std::shared_ptr<Afina::Storage>> shards;
+    for (int i = 0; i < 4; i++) {
+        shards.push_back(std::make_shared<SimpleLRU>(1 << 20));
+    }
+    ShardedStorage plain(shards);
+    ShardedStorage placed(shards, {0, 1, 0, 1});
+
+    for (int i = 0; i < 100; i++) {
+        std::string key = "key" + std::to_string(i);
+        EXPECT_EQ(-1, plain.NodeOf(key));
+        EXPECT_EQ(int(placed.ShardOf(key) % 2), placed.NodeOf(key));
+    }
+}
+
+TEST(StorageTest, HotCache) {
+    HotCache storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20));
+    std::string value;
+
+    EXPECT_TRUE(storage.Put("hot", "v1"));
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(storage.Get("hot", value));
+        EXPECT_EQ("v1", value);
+    }
+    EXPECT_GT(stat(storage, "hot_cache_hits"), 0u);
+    EXPECT_GT(stat(storage, "hot_cache_fills"), 0u);
+
+    // Writes are seen right away
+    EXPECT_TRUE(storage.Set("hot", "v2"));
+    EXPECT_TRUE(storage.Get("hot", value));
+    EXPECT_EQ("v2", value);
+    EXPECT_TRUE(storage.Delete("hot"));
+    EXPECT_FALSE(storage.Get("hot", value));
+    EXPECT_GT(stat(storage, "hot_cache_invalidations"), 0u);
+}
+
+TEST(StorageTest, HotCacheGetMany) {
+    HotCache storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20));
+    EXPECT_TRUE(storage.Put("hot", "v1"));
+    EXPECT_TRUE(storage.Put("other", "o"));
+
+    const std::string hot = "hot", other = "other", missing = "missing";
+    const std::vector<const std::string *> keys = {&hot, &missing, &other, &hot};
+    std::vector<std::string> values;
+    std::vector<bool> found;
+    for (int i = 0; i < 100; i++) {
+        storage.GetMany(keys, values, found);
+        ASSERT_EQ(4u, values.size());
+        EXPECT_EQ(std::vector<bool>({true, false, true, true}), found);
+        EXPECT_EQ("v1", values[0]);
+        EXPECT_EQ("o", values[2]);
+        EXPECT_EQ("v1", values[3]);
+    }
+    EXPECT_GT(stat(storage, "hot_cache_hits"), 0u);
+
+    // Cached copies are dropped by writes
+    EXPECT_TRUE(storage.Set("hot", "v2"));
+    storage.GetMany(keys, values, found);
+    EXPECT_EQ("v2", values[0]);
+    EXPECT_EQ("v2", values[3]);
+}
+
+TEST(StorageTest, HotCacheConcurrent) {
+    HotCache storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20));
+    storage.Put("hot", "0");
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&storage, &done]() {
+            // Cached copies never take reader back in time
+            long last = 0;
+            while (!done.load()) {
+                std::string value;
+                ASSERT_TRUE(storage.Get("hot", value));
+                long current = std::stol(value);
+                ASSERT_LE(last, current);
+                last = current;
+            }
+        });
+    }
+    for (long i = 1; i <= 20000; i++) {
+        storage.Set("hot", std::to_string(i));
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("hot", value));
+    EXPECT_EQ("20000", value);
+}
+
+TEST(StorageTest, SnapshotRoundTrip) {
+    const std::string path = "StorageTest.snapshot";
+    SimpleLRU source(1 << 20);
+    for (int i = 0; i < 100; i++) {
+        source.Put("key" + std::to_string(i), std::string(i, 'v'));
+    }
+    // Make key0 the most recently used one
+    std::string value;
+    source.Get("key0", value);
+    EXPECT_EQ(100u, Snapshot::Write(source, path));
+
+    SimpleLRU target(1 << 20);
+    EXPECT_EQ(100u, Snapshot::Load(target, path));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(target.Get("key" + std::to_string(i), value));
+        EXPECT_EQ(std::string(i, 'v'), value);
+    }
+
+    // LRU order survives: the oldest entries are evicted first from a small storage
+    std::vector<std::string> order;
+    source.ForEach([&order](const std::string &key, const std::string &) { order.push_back(key); });
+    SimpleLRU small(10 * entry_size(10));
+    Snapshot::Load(small, path);
+    EXPECT_TRUE(small.Get("key0", value));
+    EXPECT_FALSE(small.Get(order.front(), value));
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, SnapshotFork) {
+    const std::string path = "StorageTest.fork.snapshot";
+    ThreadSafeSimplLRU source(1 << 20);
+    for (int i = 0; i < 1000; i++) {
+        source.Put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+
+    pid_t pid = Snapshot::Fork(source, path);
+    ASSERT_GT(pid, 0);
+    // Parent keeps changing storage, child writes the state as of fork
+    source.Put("key0", "changed");
+    int status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+
+    SimpleLRU target(1 << 20);
+    EXPECT_EQ(1000u, Snapshot::Load(target, path));
+    std::string value;
+    EXPECT_TRUE(target.Get("key0", value));
+    EXPECT_EQ("value0", value);
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, SnapshotForkNeedsQuiesce) {
+    SimpleLRU plain(1 << 20);
+    EXPECT_FALSE(plain.CanQuiesce());
+    EXPECT_THROW(Snapshot::Fork(plain, "StorageTest.plain.snapshot"), std::runtime_error);
+
+    std::vector<std::shared_ptr<Afina::Storage>> parts;
+    parts.push_back(std::make_shared<ThreadSafeSimplLRU>(1 << 20));
+    parts.push_back(std::make_shared<SimpleLRU>(1 << 20));
+    EXPECT_FALSE(ShardedStorage(std::move(parts)).CanQuiesce());
+    EXPECT_TRUE(ThreadSafeSimplLRU(1 << 20).CanQuiesce());
+}
+
+TEST(StorageTest, SnapshotCorrupted) {
+    const std::string path = "StorageTest.bad.snapshot";
+    SimpleLRU source(1 << 20);
+    source.Put("key", "value");
+    Snapshot::Write(source, path);
+
+    // Flip a byte of the value
+    FILE *file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    std::fseek(file, 13, SEEK_SET);
+    std::fputc('X', file);
+    std::fclose(file);
+
+    SimpleLRU target(1 << 20);
+    EXPECT_THROW(Snapshot::Load(target, path), std::runtime_error);
+    std::string value;
+    EXPECT_FALSE(target.Get("key", value));
+    EXPECT_THROW(Snapshot::Load(target, "no-such.snapshot"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, MappedReopen) {
+    const std::string path = "StorageTest.mapped";
+    std::remove(path.c_str());
+    {
+        MappedStorage storage(path, 1 << 20);
+        EXPECT_EQ("created", storage.OpenState());
+        for (int i = 0; i < 100; i++) {
+            storage.Put("key" + std::to_string(i), "value" + std::to_string(i));
+        }
+        EXPECT_TRUE(storage.Set("key1", "changed"));
+        EXPECT_TRUE(storage.Delete("key2"));
+        EXPECT_FALSE(storage.PutIfAbsent("key3", "other"));
+    }
+
+    // Different sizes don't matter for existing file
+    MappedStorage storage(path, 4 << 20, 100000);
+    EXPECT_EQ("clean", storage.OpenState());
+    std::string value;
+    EXPECT_TRUE(storage.Get("key1", value));
+    EXPECT_EQ("changed", value);
+    EXPECT_FALSE(storage.Get("key2", value));
+    for (int i = 3; i < 100; i++) {
+        ASSERT_TRUE(storage.Get("key" + std::to_string(i), value));
+        EXPECT_EQ("value" + std::to_string(i), value);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, MappedEvictsOldest) {
+    const std::string path = "StorageTest.small.mapped";
+    std::remove(path.c_str());
+    MappedStorage storage(path, 64 << 10);
+    const std::string big(1000, 'v');
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(storage.Put("key" + std::to_string(i), big));
+    }
+    EXPECT_FALSE(storage.Put("huge", std::string(65 << 10, 'v')));
+
+    // Log wrapped many times, the newest entries survive and everything found is intact
+    std::string value;
+    EXPECT_TRUE(storage.Get("key999", value));
+    EXPECT_FALSE(storage.Get("key0", value));
+    std::size_t found = 0;
+    for (int i = 0; i < 1000; i++) {
+        if (storage.Get("key" + std::to_string(i), value)) {
+            EXPECT_EQ(big, value);
+            found++;
+        }
+    }
+    std::size_t visited = 0;
+    storage.ForEach([&visited](const std::string &, const std::string &) { visited++; });
+    EXPECT_EQ(found, visited);
+    EXPECT_GT(found, 50u);
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, MappedRecovery) {
+    const std::string path = "StorageTest.crash.mapped";
+    std::remove(path.c_str());
+    {
+        MappedStorage storage(path, 1 << 20);
+        storage.Put("old", "value");
+    }
+
+    // Child dies without closing the file
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        MappedStorage *storage = new MappedStorage(path, 1 << 20);
+        for (int i = 0; i < 100; i++) {
+            storage->Put("key" + std::to_string(i), "value" + std::to_string(i));
+        }
+        storage->Delete("old");
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+
+    MappedStorage storage(path, 1 << 20);
+    EXPECT_EQ("recovered", storage.OpenState());
+    std::string value;
+    EXPECT_FALSE(storage.Get("old", value));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(storage.Get("key" + std::to_string(i), value));
+        EXPECT_EQ("value" + std::to_string(i), value);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, MappedRecoversTornHeader) {
+    const std::string path = "StorageTest.torn.mapped";
+    std::remove(path.c_str());
+    {
+        MappedStorage storage(path, 1 << 20);
+        for (int i = 0; i < 100; i++) {
+            storage.Put("key" + std::to_string(i), "value" + std::to_string(i));
+        }
+    }
+
+    // Crash between the stores of the last eviction: used is already decreased, head is not moved.
+    // Header is magic, arena size, index slots, geometry checksum, head, tail, used, items, clean
+    int fd = open(path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    uint64_t used = 0, clean = 0;
+    ASSERT_EQ(8, pread(fd, &used, sizeof(used), 48));
+    used -= 8;
+    ASSERT_EQ(8, pwrite(fd, &used, sizeof(used), 48));
+    ASSERT_EQ(8, pwrite(fd, &clean, sizeof(clean), 64));
+    close(fd);
+
+    MappedStorage storage(path, 1 << 20);
+    EXPECT_EQ("recovered", storage.OpenState());
+    std::string value;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(storage.Get("key" + std::to_string(i), value));
+        EXPECT_EQ("value" + std::to_string(i), value);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StorageTest, JournalReplay) {
+    const std::string path = "StorageTest.wal";
+    {
+        auto journal = std::make_shared<Journal>(path);
+        LoggedStorage storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20), journal);
+        EXPECT_EQ(0u, storage.Recover());
+
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; t++) {
+            writers.emplace_back([&storage, t]() {
+                for (int i = 0; i < 100; i++) {
+                    storage.Put("key" + std::to_string(t * 100 + i), "value" + std::to_string(i));
+                }
+            });
+        }
+        for (auto &w : writers) {
+            w.join();
+        }
+        EXPECT_TRUE(storage.Set("key0", "changed"));
+        EXPECT_FALSE(storage.Set("missing", "value"));
+        EXPECT_TRUE(storage.Delete("key1"));
+        storage.Stop();
+    }
+
+    // Torn record at the end of the segment is ignored
+    FILE *file = std::fopen((path + ".1").c_str(), "ab");
+    ASSERT_NE(nullptr, file);
+    std::fputs("P\x05", file);
+    std::fclose(file);
+
+    SimpleLRU target(1 << 20);
+    Journal journal(path);
+    EXPECT_EQ(402u, journal.Replay(target));
+    std::string value;
+    EXPECT_TRUE(target.Get("key0", value));
+    EXPECT_EQ("changed", value);
+    EXPECT_FALSE(target.Get("key1", value));
+    EXPECT_FALSE(target.Get("missing", value));
+    EXPECT_TRUE(target.Get("key399", value));
+    EXPECT_EQ("value99", value);
+    journal.Compact(2);
+    EXPECT_EQ(0u, journal.Replay(target));
+}
+
+TEST(StorageTest, JournalFailureIsReported) {
+    const std::string dir = "StorageTest.wal.dir";
+    ASSERT_EQ(0, mkdir(dir.c_str(), 0755));
+    auto journal = std::make_shared<Journal>(dir + "/wal");
+    LoggedStorage storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20), journal);
+    storage.Recover();
+    EXPECT_TRUE(storage.Put("before", "1"));
+
+    // Next segment can't be created, records must not be reported as stored
+    ASSERT_EQ(0, unlink((dir + "/wal.1").c_str()));
+    ASSERT_EQ(0, rmdir(dir.c_str()));
+    storage.Quiesce([]() {});
+    EXPECT_FALSE(storage.Put("after", "2"));
+    EXPECT_FALSE(storage.Delete("before"));
+    EXPECT_EQ(1, stat(storage, "wal_failed"));
+
+    storage.Stop();
+}
+
+TEST(StorageTest, JournalCompaction) {
+    const std::string path = "StorageTest.compact.wal";
+    const std::string snapshot = "StorageTest.wal.snapshot";
+    auto journal = std::make_shared<Journal>(path);
+    LoggedStorage storage(std::make_shared<ThreadSafeSimplLRU>(1 << 20), journal);
+    storage.Recover();
+    storage.Put("before", "1");
+
+    // Snapshot covers changes made before it, journal segment started by it keeps the rest
+    uint64_t segment = 0;
+    storage.Quiesce([&]() {
+        segment = journal->Segment();
+        Snapshot::Write(storage, snapshot);
+    });
+    storage.Put("after", "2");
+    storage.Delete("before");
+    storage.Stop();
+    journal->Compact(segment);
+
+    SimpleLRU target(1 << 20);
+    EXPECT_EQ(1u, Snapshot::Load(target, snapshot));
+    EXPECT_EQ(2u, Journal(path).Replay(target));
+    std::string value;
+    EXPECT_FALSE(target.Get("before", value));
+    EXPECT_TRUE(target.Get("after", value));
+    Journal(path).Compact(segment + 1);
+    std::remove(snapshot.c_str());
+}